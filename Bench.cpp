@@ -0,0 +1,470 @@
+/*
+ *  Software Systems CPP Course Assignment 3
+ *  Copyright (C) 2023  Roy Simanovich
+ * 
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ * 
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <https://www.gnu.org/licenses/>.
+*/
+
+/*
+ * Benchmark suite of the Fraction library.
+ *
+ * Usage: ./benchmark [--filter TEXT] [--json FILE] [--baseline FILE] [--threshold PERCENT] [--min-time MS]
+ *   --filter     Runs only the benchmarks whose name contains TEXT.
+ *   --json       Writes the results to FILE in JSON format.
+ *   --baseline   Compares the results to a JSON file written by --json, exits with 1 on a regression.
+ *   --threshold  The slowdown (in percent) that counts as a regression (default 10).
+ *   --min-time   The minimal time (in milliseconds) of every sample (default 20).
+*/
+
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <cstring>
+#include <fstream>
+#include <functional>
+#include <iomanip>
+#include <iostream>
+#include <map>
+#include <random>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <type_traits>
+#include <vector>
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <x86intrin.h>
+#endif
+
+#include "sources/Fraction.hpp"
+#include "sources/FractionAccumulator.hpp"
+#include "sources/FractionBatch.hpp"
+#include "sources/FractionExpr.hpp"
+#include "sources/FractionMath.hpp"
+#include "sources/FractionParallel.hpp"
+
+using namespace std;
+using namespace ariel;
+
+/*
+ * @brief The number of inputs every benchmark cycles through (a power of 2, fits in L1/L2).
+*/
+static const size_t INPUTS = 4096;
+
+/*
+ * @brief The number of samples of every benchmark, the fastest one is reported.
+*/
+static const int SAMPLES = 5;
+
+/*
+ * @brief The usage line, printed on a bad option.
+*/
+static const char* const USAGE = "Usage: ./benchmark [--filter TEXT] [--json FILE] [--baseline FILE] [--threshold PERCENT] [--min-time MS]";
+
+/*
+ * @brief The result of a single benchmark.
+*/
+struct Result
+{
+    string name;
+    double ns_per_op;
+    double ops_per_sec;
+    double cycles_per_op;
+};
+
+/*
+ * @brief Keeps the compiler from optimizing away a value.
+ * @param value The value to keep.
+*/
+template <typename T>
+static inline void keep(const T& value) {
+    asm volatile("" : : "g"(&value) : "memory");
+}
+
+/*
+ * @brief Reads the CPU timestamp counter.
+ * @return uint64_t The timestamp counter, or 0 if it isn't available on this architecture.
+*/
+static inline uint64_t cycles() {
+#if defined(__x86_64__) || defined(__i386__)
+    return __rdtsc();
+#else
+    return 0;
+#endif
+}
+
+/*
+ * @brief Realistic inputs: small and medium fractions, both signs, and floats with up to 3 decimal digits.
+ * @note The batch inputs are bounded (divisors of 24 as denominators, a telescoping chain for products) so their sums and products fit in a Fraction.
+*/
+struct Inputs
+{
+    static constexpr int DENOMINATORS[] = {1, 2, 3, 4, 6, 8, 12, 24};
+
+    vector<Fraction> fractions;
+    vector<Fraction> nonzero;
+    vector<float> floats;
+    vector<float> nonzero_floats;
+    vector<int> numerators;
+    vector<int> denominators;
+    vector<string> texts;
+    vector<Fraction> ratios;
+    vector<Fraction> integers;
+    vector<Fraction> chain;
+
+    Inputs() {
+        mt19937 random(20230301);
+        uniform_int_distribution<int> small(-100, 100);
+        uniform_int_distribution<int> medium(1, 5000);
+        uniform_int_distribution<int> decimals(-99999, 99999);
+
+        for (size_t i = 0; i < INPUTS; i++)
+        {
+            // 3 out of 4 fractions are small, the rest have medium sized denominators.
+            int numerator = small(random);
+            int denominator = (i % 4 == 3) ? medium(random) : (small(random) % 12 + 13);
+
+            numerators.push_back(numerator);
+            denominators.push_back(denominator);
+            fractions.push_back(Fraction(numerator, denominator));
+            nonzero.push_back(Fraction((numerator == 0) ? 1 : numerator, denominator));
+            floats.push_back(static_cast<float>(decimals(random)) / 1000.0f);
+            nonzero_floats.push_back((floats.back() == 0) ? 1.0f : floats.back());
+
+            ratios.push_back(Fraction(numerator, DENOMINATORS[i % 8]));
+            integers.push_back(Fraction(numerator % 10, 1));
+            chain.push_back(Fraction(static_cast<int>(i) + 2, static_cast<int>(i) + 1));
+
+            ostringstream text;
+            text << fractions.back();
+            texts.push_back(text.str());
+        }
+    }
+};
+
+/*
+ * @brief Runs a benchmark.
+ * @param name The name of the benchmark.
+ * @param ops_per_call The number of operations a single call of the body does.
+ * @param min_time The minimal time of every sample.
+ * @param body The benchmark body, called with the index of the input to use.
+ * @return Result The fastest sample.
+*/
+static Result run(const string& name, size_t ops_per_call, chrono::nanoseconds min_time, const function<void(size_t)>& body) {
+    // Calibrate the number of calls per sample.
+    size_t calls = 1;
+
+    while (true)
+    {
+        auto start = chrono::steady_clock::now();
+
+        for (size_t i = 0; i < calls; i++)
+            body(i & (INPUTS - 1));
+
+        if (chrono::steady_clock::now() - start >= min_time / 4 || calls >= (1ULL << 30))
+            break;
+
+        calls *= 2;
+    }
+
+    calls *= 4;
+
+    double best_ns = 0;
+    double best_cycles = 0;
+
+    for (int sample = 0; sample < SAMPLES; sample++)
+    {
+        uint64_t start_cycles = cycles();
+        auto start = chrono::steady_clock::now();
+
+        for (size_t i = 0; i < calls; i++)
+            body(i & (INPUTS - 1));
+
+        auto elapsed = chrono::duration<double, nano>(chrono::steady_clock::now() - start).count();
+        uint64_t elapsed_cycles = cycles() - start_cycles;
+
+        double ops = static_cast<double>(calls * ops_per_call);
+
+        if (sample == 0 || elapsed / ops < best_ns)
+        {
+            best_ns = elapsed / ops;
+            best_cycles = static_cast<double>(elapsed_cycles) / ops;
+        }
+    }
+
+    return {name, best_ns, 1e9 / best_ns, best_cycles};
+}
+
+/*
+ * @brief Registers all the benchmarks.
+ * @param in The inputs.
+ * @return vector The benchmarks: name, operations per call and body.
+*/
+static vector<tuple<string, size_t, function<void(size_t)>>> benchmarks(Inputs& in) {
+    vector<tuple<string, size_t, function<void(size_t)>>> list;
+
+    auto& f = in.fractions;
+    auto& nz = in.nonzero;
+    auto& fl = in.floats;
+    auto& nzfl = in.nonzero_floats;
+    auto next = [](size_t i) { return (i + 1) & (INPUTS - 1); };
+
+    // Construction
+    list.push_back({"construct/int", 1, [&](size_t i) { keep(Fraction(in.numerators[i], in.denominators[i])); }});
+    list.push_back({"construct/float", 1, [&](size_t i) { keep(Fraction(fl[i])); }});
+    list.push_back({"construct/make", 1, [&](size_t i) { keep(Fraction::make(in.numerators[i], in.denominators[i])); }});
+
+    // Arithmetic
+    list.push_back({"arith/add", 1, [&](size_t i) { keep(f[i] + f[next(i)]); }});
+    list.push_back({"arith/sub", 1, [&](size_t i) { keep(f[i] - f[next(i)]); }});
+    list.push_back({"arith/mul", 1, [&](size_t i) { keep(f[i] * f[next(i)]); }});
+    list.push_back({"arith/div", 1, [&](size_t i) { keep(f[i] / nz[next(i)]); }});
+    list.push_back({"arith/add_float", 1, [&](size_t i) { keep(f[i] + fl[i]); }});
+    list.push_back({"arith/sub_float", 1, [&](size_t i) { keep(fl[i] - f[i]); }});
+    list.push_back({"arith/mul_float", 1, [&](size_t i) { keep(f[i] * fl[i]); }});
+    list.push_back({"arith/div_float", 1, [&](size_t i) { keep(fl[i] / nz[i]); }});
+    list.push_back({"arith/neg", 1, [&](size_t i) { keep(-f[i]); }});
+    list.push_back({"arith/pos", 1, [&](size_t i) { keep(+f[i]); }});
+    list.push_back({"arith/checked_add", 1, [&](size_t i) { keep(checked_add(f[i], f[next(i)])); }});
+    list.push_back({"arith/checked_div", 1, [&](size_t i) { keep(checked_div(f[i], f[next(i)])); }});
+    list.push_back({"arith/fma", 1, [&](size_t i) { keep(ariel::fma(f[i], f[next(i)], f[next(next(i))])); }});
+    list.push_back({"arith/expr", 1, [&](size_t i) { keep(evaluate(lazy(f[i]) + f[next(i)] - 1)); }});
+
+    // Compound assignment (on a copy, so the values don't drift)
+    list.push_back({"compound/add", 1, [&](size_t i) { Fraction x = f[i]; keep(x += f[next(i)]); }});
+    list.push_back({"compound/sub", 1, [&](size_t i) { Fraction x = f[i]; keep(x -= f[next(i)]); }});
+    list.push_back({"compound/mul", 1, [&](size_t i) { Fraction x = f[i]; keep(x *= f[next(i)]); }});
+    list.push_back({"compound/div", 1, [&](size_t i) { Fraction x = f[i]; keep(x /= nz[next(i)]); }});
+    list.push_back({"compound/add_float", 1, [&](size_t i) { Fraction x = f[i]; keep(x += fl[i]); }});
+    list.push_back({"compound/sub_float", 1, [&](size_t i) { Fraction x = f[i]; keep(x -= fl[i]); }});
+    list.push_back({"compound/mul_float", 1, [&](size_t i) { Fraction x = f[i]; keep(x *= fl[i]); }});
+    list.push_back({"compound/div_float", 1, [&](size_t i) { Fraction x = f[i]; keep(x /= nzfl[i]); }});
+    list.push_back({"compound/increment", 1, [&](size_t i) { Fraction x = f[i]; keep(++x); }});
+    list.push_back({"compound/decrement", 1, [&](size_t i) { Fraction x = f[i]; keep(--x); }});
+    list.push_back({"compound/post_increment", 1, [&](size_t i) { Fraction x = f[i]; keep(x++); }});
+    list.push_back({"compound/post_decrement", 1, [&](size_t i) { Fraction x = f[i]; keep(x--); }});
+
+    // Comparison
+    list.push_back({"compare/eq", 1, [&](size_t i) { keep(f[i] == f[next(i)]); }});
+    list.push_back({"compare/ne", 1, [&](size_t i) { keep(f[i] != f[next(i)]); }});
+    list.push_back({"compare/lt", 1, [&](size_t i) { keep(f[i] < f[next(i)]); }});
+    list.push_back({"compare/gt", 1, [&](size_t i) { keep(f[i] > f[next(i)]); }});
+    list.push_back({"compare/le", 1, [&](size_t i) { keep(f[i] <= f[next(i)]); }});
+    list.push_back({"compare/ge", 1, [&](size_t i) { keep(f[i] >= f[next(i)]); }});
+    list.push_back({"compare/eq_float", 1, [&](size_t i) { keep(f[i] == fl[i]); }});
+    list.push_back({"compare/ne_float", 1, [&](size_t i) { keep(fl[i] != f[i]); }});
+    list.push_back({"compare/lt_float", 1, [&](size_t i) { keep(f[i] < fl[i]); }});
+    list.push_back({"compare/gt_float", 1, [&](size_t i) { keep(fl[i] > f[i]); }});
+    list.push_back({"compare/le_float", 1, [&](size_t i) { keep(f[i] <= fl[i]); }});
+    list.push_back({"compare/ge_float", 1, [&](size_t i) { keep(fl[i] >= f[i]); }});
+
+    // Stream I/O
+    list.push_back({"io/write", 1, [&](size_t i) { ostringstream out; out << f[i]; keep(out.tellp()); }});
+    list.push_back({"io/read", 1, [&](size_t i) { istringstream input(in.texts[i]); Fraction x; input >> x; keep(x); }});
+
+    // Batch paths (every call processes all the inputs)
+    list.push_back({"batch/accumulator", INPUTS, [&](size_t) { FractionAccumulator acc; for (const Fraction& x : in.ratios) acc += x; keep(acc.result()); }});
+    list.push_back({"batch/parallel_sum", INPUTS, [&](size_t) { keep(parallel_sum(in.ratios)); }});
+    list.push_back({"batch/parallel_product", INPUTS, [&](size_t) { keep(parallel_product(in.chain)); }});
+    list.push_back({"batch/dot", INPUTS, [&](size_t) { keep(dot(in.ratios, in.integers)); }});
+
+    list.push_back({"batch/axpy", INPUTS, [&](size_t) { vector<Fraction> y = in.integers; axpy(Fraction(1, 2), in.ratios, y); keep(y[0]); }});
+
+    return list;
+}
+
+/*
+ * @brief Writes the results in JSON format.
+ * @param path The path of the JSON file.
+ * @param results The results.
+ * @note Every benchmark is written on its own line, which is what readBaseline() expects.
+*/
+static void writeJson(const string& path, const vector<Result>& results) {
+    ofstream out(path);
+    out << setprecision(6) << fixed;
+    out << "{\n  \"benchmarks\": [\n";
+
+    for (size_t i = 0; i < results.size(); i++)
+    {
+        const Result& r = results[i];
+        out << "    {\"name\": \"" << r.name << "\", \"ns_per_op\": " << r.ns_per_op
+            << ", \"ops_per_sec\": " << r.ops_per_sec << ", \"cycles_per_op\": " << r.cycles_per_op << "}"
+            << ((i + 1 < results.size()) ? "," : "") << "\n";
+    }
+
+    out << "  ]\n}\n";
+}
+
+/*
+ * @brief Reads the ns/op of every benchmark from a JSON file written by writeJson().
+ * @param path The path of the JSON file.
+ * @return map The ns/op of every benchmark, by name.
+*/
+static map<string, double> readBaseline(const string& path) {
+    map<string, double> baseline;
+    ifstream input(path);
+    string line;
+
+    if (!input)
+        throw invalid_argument("Can't open baseline file " + path);
+
+    while (getline(input, line))
+    {
+        size_t name = line.find("\"name\": \"");
+        size_t ns = line.find("\"ns_per_op\": ");
+
+        if (name == string::npos || ns == string::npos)
+            continue;
+
+        name += 9;
+        baseline[line.substr(name, line.find('"', name) - name)] = stod(line.substr(ns + 13));
+    }
+
+    return baseline;
+}
+
+/*
+ * @brief Parses a positive number option value.
+ * @param text The value.
+ * @param value The parsed number, set only if the value is valid.
+ * @return True if the whole value is a positive number, false otherwise.
+*/
+template <typename T>
+static bool parsePositive(const string& text, T& value) {
+    size_t end = 0;
+    T parsed;
+
+    try
+    {
+        if constexpr (is_floating_point_v<T>)
+            parsed = stod(text, &end);
+
+        else
+            parsed = stol(text, &end);
+    }
+
+    catch (const invalid_argument&)
+    {
+        return false;
+    }
+
+    catch (const out_of_range&)
+    {
+        return false;
+    }
+
+    // Trailing garbage ("10abc") and NaN are rejected as well.
+    if (end != text.size() || !(parsed > 0))
+        return false;
+
+    value = parsed;
+    return true;
+}
+
+int main(int argc, char** argv) {
+    string filter, json, baseline_path;
+    double threshold = 10;
+    long min_time_ms = 20;
+
+    for (int i = 1; i < argc; i++)
+    {
+        string arg = argv[i];
+
+        if (arg != "--filter" && arg != "--json" && arg != "--baseline" && arg != "--threshold" && arg != "--min-time")
+        {
+            cerr << "Unknown option " << arg << endl << USAGE << endl;
+            return 2;
+        }
+
+        // Every option takes a value.
+        if (i + 1 >= argc)
+        {
+            cerr << "Missing value for " << arg << endl << USAGE << endl;
+            return 2;
+        }
+
+        string value = argv[++i];
+
+        if (arg == "--filter")
+            filter = value;
+
+        else if (arg == "--json")
+            json = value;
+
+        else if (arg == "--baseline")
+            baseline_path = value;
+
+        else if ((arg == "--threshold") ? !parsePositive(value, threshold) : !parsePositive(value, min_time_ms))
+        {
+            cerr << "Invalid value for " << arg << ": " << value << " (must be a positive number)" << endl << USAGE << endl;
+            return 2;
+        }
+    }
+
+    Inputs inputs;
+    vector<Result> results;
+
+    cout << left << setw(26) << "benchmark" << right << setw(12) << "ns/op" << setw(16) << "ops/s" << setw(12) << "cycles/op" << endl;
+
+    for (auto& [name, ops, body] : benchmarks(inputs))
+    {
+        if (!filter.empty() && name.find(filter) == string::npos)
+            continue;
+
+        Result r = run(name, ops, chrono::milliseconds(min_time_ms), body);
+        results.push_back(r);
+
+        cout << left << setw(26) << r.name << right << fixed << setprecision(2) << setw(12) << r.ns_per_op
+             << setprecision(0) << setw(16) << r.ops_per_sec << setprecision(1) << setw(12) << r.cycles_per_op << endl;
+    }
+
+    if (!json.empty())
+        writeJson(json, results);
+
+    if (baseline_path.empty())
+        return 0;
+
+    map<string, double> baseline;
+
+    try
+    {
+        baseline = readBaseline(baseline_path);
+    }
+
+    catch (const exception& error)
+    {
+        cerr << error.what() << endl;
+        return 2;
+    }
+
+    int regressions = 0;
+
+    cout << endl << "Compared to " << baseline_path << " (threshold " << threshold << "%):" << endl;
+
+    for (const Result& r : results)
+    {
+        auto old = baseline.find(r.name);
+
+        if (old == baseline.end() || old->second <= 0)
+            continue;
+
+        double change = (r.ns_per_op - old->second) / old->second * 100;
+        bool regression = change > threshold;
+        regressions += regression ? 1 : 0;
+
+        cout << left << setw(26) << r.name << right << showpos << fixed << setprecision(1) << setw(10) << change << "%" << noshowpos
+             << (regression ? "  REGRESSION" : "") << endl;
+    }
+
+    return (regressions > 0) ? 1 : 0;
+}
@@ -14,10 +14,32 @@
  *  You should have received a copy of the GNU General Public License
  *  along with this program.  If not, see <https://www.gnu.org/licenses/>.
 */
+#include <algorithm>
+#include <cmath>
+#include <iomanip>
 #include <iostream>
 #include <stdexcept>
+#include <sstream>
+#include <thread>
+#include <vector>
 #include "doctest.h"
 #include "sources/Fraction.hpp"
+#include "sources/BoundedFraction.hpp"
+#include "sources/CommonDenominatorVector.hpp"
+#include "sources/ConcurrentFractionSum.hpp"
+#include "sources/DyadicFraction.hpp"
+#include "sources/FixedFraction.hpp"
+#include "sources/FractionAccumulator.hpp"
+#include "sources/FractionAtomic.hpp"
+#include "sources/FractionBatch.hpp"
+#include "sources/FractionExpr.hpp"
+#include "sources/FractionMath.hpp"
+#include "sources/FractionMetrics.hpp"
+#include "sources/FractionParallel.hpp"
+#include "sources/FractionStats.hpp"
+#include "sources/ShadowedFraction.hpp"
+#include "sources/SmallFraction.hpp"
+#include "sources/ThreadPool.hpp"
 
 using namespace std;
 using namespace ariel;
@@ -206,4 +228,845 @@ TEST_CASE("Test 13: Division by zero")
 
     CHECK_THROWS_AS(a / b, std::invalid_argument);
     CHECK_NOTHROW(b / a);
-}
\ No newline at end of file
+}
+
+TEST_CASE("Test 14: Fraction accumulator sums exactly")
+{
+    FractionAccumulator acc;
+    CHECK(acc.result() == 0);
+
+    for (int i = 0; i < 1000; i++)
+        acc += Fraction(1, 3);
+
+    acc += Fraction(1, 2);
+    acc += Fraction(-1, 6);
+
+    CHECK(acc.count() == 1002);
+    CHECK(acc.groups() == 3);
+    CHECK(acc.result() == Fraction(1001, 3));
+
+    acc.reset();
+    CHECK(acc.result() == 0);
+}
+
+TEST_CASE("Test 15: Fraction accumulator merge and overflow")
+{
+    FractionAccumulator a, b;
+
+    a += Fraction(1, 4);
+    b += Fraction(3, 4);
+    b += Fraction(1, 7);
+    a += b;
+
+    CHECK(a.result() == Fraction(8, 7));
+
+    FractionAccumulator c;
+    for (int i = 0; i < 10; i++)
+    {
+        c += Fraction(1, 1009);
+        c += Fraction(-1, 1013);
+    }
+
+    CHECK(c.result() == Fraction(40, 1022117));
+
+    // Merging into itself doubles the sum, even with enough groups to rehash.
+    FractionAccumulator e;
+    for (int i = 1; i <= 64; i++)
+        e += Fraction(1, i % 8 + 1);
+
+    Fraction single = e.result();
+    e.merge(e);
+    CHECK(e.result() == single * 2);
+    CHECK(e.count() == 128);
+
+    FractionAccumulator d;
+    d += Fraction(1, 2147483647);
+    d += Fraction(1, 2147483646);
+    CHECK_THROWS_AS(d.result(), std::overflow_error);
+
+    // A sum that overflows throws without touching the accumulator: (2^31 - 1) * 2^32 fits, twice that doesn't.
+    FractionAccumulator big, negative;
+    big += Fraction(2147483647, 1);
+    negative += Fraction(-2147483647, 1);
+
+    for (int i = 0; i < 32; i++)
+    {
+        big.merge(big);
+        negative.merge(negative);
+    }
+
+    FractionAccumulator pending(big);
+    CHECK_THROWS_AS(pending.merge(big), std::overflow_error);
+    pending.merge(negative);
+    CHECK(pending.result() == Fraction(0, 1));
+
+    FractionAccumulator grouped(big);
+    grouped += Fraction(1, 2);
+    grouped += Fraction(-1, 2);
+    grouped.merge(big);
+    CHECK_THROWS_AS(grouped += Fraction(1, 3), std::overflow_error);
+    grouped.merge(negative);
+    grouped.merge(negative);
+    CHECK(grouped.result() == Fraction(0, 1));
+}
+
+TEST_CASE("Test 16: Parallel sum and product match the serial fold")
+{
+    std::vector<Fraction> values;
+    for (int i = 1; i <= 20000; i++)
+        values.push_back(Fraction((i % 7) - 3, (i % 5) + 1));
+
+    Fraction serial;
+    for (const Fraction& value : values)
+        serial += value;
+
+    CHECK(parallel_sum(values, 1) == serial);
+    CHECK(parallel_sum(values, 4) == serial);
+    CHECK(parallel_sum(values) == serial);
+    CHECK(parallel_sum(std::vector<Fraction>()) == 0);
+
+    std::vector<Fraction> factors;
+    for (int i = 1; i <= 20000; i++)
+        factors.push_back(Fraction(i + 1, i));
+
+    CHECK(parallel_product(factors, 1) == 20001);
+    CHECK(parallel_product(factors, 3) == 20001);
+    CHECK(parallel_product(factors, 8) == 20001);
+    CHECK(parallel_product(std::vector<Fraction>()) == 1);
+}
+
+TEST_CASE("Test 17: Work-stealing thread pool")
+{
+    ThreadPool pool(3);
+    CHECK(pool.workers() == 3);
+
+    auto answer = pool.submit([]() { return 42; });
+    CHECK(answer.get() == 42);
+
+    std::vector<int> squares(100, 0);
+    pool.parallel_for(squares.size(), [&squares](size_t i) { squares[i] = static_cast<int>(i * i); });
+    CHECK(squares[99] == 9801);
+
+    // Nested calls run on the same pool without deadlocking.
+    std::vector<Fraction> values(10000, Fraction(1, 4));
+    std::vector<Fraction> sums(4);
+    pool.parallel_for(sums.size(), [&](size_t i) { sums[i] = parallel_sum(values); });
+    CHECK(sums[3] == 2500);
+
+    CHECK_THROWS_AS(pool.parallel_for(4, [](size_t i) { if (i == 2) throw std::invalid_argument("chunk"); }), std::invalid_argument);
+}
+
+TEST_CASE("Test 18: Expression templates evaluate like the eager operators")
+{
+    Fraction a(5, 3), b(14, 21);
+
+    Fraction c = lazy(a) + b - 1;
+    CHECK(c == a + b - 1);
+
+    Fraction d = (lazy(a) * b + 2.421) / (1 - lazy(b));
+    CHECK(d == (a * b + 2.421) / (1 - b));
+
+    CHECK(evaluate(2 * lazy(a) - a / b) == Fraction(5, 6));
+    CHECK(evaluate(lazy(a) / -2) == Fraction(-5, 6));
+    CHECK_THROWS_AS(evaluate(lazy(a) / (lazy(b) - b)), std::invalid_argument);
+
+    // The eager product overflows an int after the first operator, the lazy one evaluates on wide values.
+    Fraction product = lazy(Fraction(100000, 7)) * Fraction(100000, 3) * Fraction(9, 100000);
+    CHECK(product == Fraction(300000, 7));
+
+    // Unreduced operands whose common factors don't cross-cancel: 5/7 * 11/13, scaled by 2^40 and 3^25.
+    expr::Raw left{5LL << 40, 7LL << 40}, right{11LL * 847288609443LL, 13LL * 847288609443LL};
+    CHECK(expr::reduce(expr::mul(left, right)) == Fraction(55, 91));
+}
+
+TEST_CASE("Test 19: Fused multiply-add")
+{
+    Fraction a(2, 3), b(9, 4), c(-1, 6);
+
+    CHECK(ariel::fma(a, b, c) == a * b + c);
+    CHECK(ariel::fma(a, 0, c) == c);
+    CHECK(ariel::fma(Fraction(-1, 2), Fraction(1, 2), Fraction(1, 4)) == 0);
+
+    // a * b alone overflows an int before it is reduced, the fused version doesn't.
+    CHECK(ariel::fma(Fraction(65536, 7), Fraction(65536, 1), Fraction(-613566756, 1)) == Fraction(4, 7));
+    CHECK_THROWS_AS(ariel::fma(Fraction(65536, 1), Fraction(65536, 1), Fraction(0, 1)), std::overflow_error);
+}
+
+TEST_CASE("Test 20: Batch axpy and dot")
+{
+    std::vector<Fraction> x, y;
+    for (int i = 1; i <= 10000; i++)
+    {
+        x.push_back(Fraction(1, i % 10 + 1));
+        y.push_back(Fraction(i % 3, 1));
+    }
+
+    Fraction serial;
+    for (size_t i = 0; i < x.size(); i++)
+        serial += x[i] * y[i];
+
+    CHECK(dot(x, y) == serial);
+
+    axpy(Fraction(1, 2), x, y);
+    CHECK(y[0] == Fraction(1, 2) * x[0] + 1);
+    CHECK(y[9999] == Fraction(1, 2) * x[9999] + 1);
+
+    CHECK_THROWS_AS(dot(x, std::vector<Fraction>(3)), std::invalid_argument);
+}
+
+TEST_CASE("Test 21: Exception-free API")
+{
+    FractionResult r = Fraction::make(2, -4);
+    CHECK(r.has_value());
+    CHECK(r.value == Fraction(-1, 2));
+
+    CHECK(Fraction::make(1, 0).error == FractionError::ZeroDenominator);
+    CHECK_FALSE(Fraction::make(1, 0));
+
+    CHECK(checked_add(Fraction(1, 2), Fraction(1, 3)).value == Fraction(5, 6));
+    CHECK(checked_sub(Fraction(1, 2), Fraction(1, 3)).value == Fraction(1, 6));
+    CHECK(checked_mul(Fraction(1, 2), Fraction(1, 3)).value == Fraction(1, 6));
+    CHECK(checked_div(Fraction(1, 2), Fraction(-1, 3)).value == Fraction(-3, 2));
+    CHECK(checked_div(Fraction(1, 2), Fraction(0, 1)).error == FractionError::DivisionByZero);
+    CHECK(checked_mul(Fraction(65536, 1), Fraction(65536, 1)).error == FractionError::Overflow);
+    CHECK(checked_add(Fraction(1, 65536), Fraction(1, 65537)).error == FractionError::Overflow);
+
+    Fraction a(1, 2), b(1, 3);
+    CHECK(noexcept(-a));
+    CHECK(noexcept(a < b));
+    CHECK_FALSE(noexcept(a / b));
+
+    // The operators work over 64 bits: wrapped int products no longer leak out as broken fractions.
+    CHECK(Fraction(65536, 65537) * Fraction(65537, 65536) == Fraction(1, 1));
+    CHECK(Fraction(2147483647, 2) - Fraction(2147483645, 2) == Fraction(1, 1));
+    CHECK_THROWS_AS(Fraction(1, 65536) + Fraction(1, 65537), overflow_error);
+    CHECK_THROWS_AS(Fraction(65536, 1) * Fraction(65536, 1), overflow_error);
+    CHECK_THROWS_AS(a += Fraction(1, 2147483647), overflow_error);
+    CHECK(a == Fraction(1, 2));
+
+    // Dividing by a negative fraction keeps the denominator positive.
+    a /= Fraction(-1, 2);
+    CHECK(a.denominator() > 0);
+    CHECK(a == -1);
+}
+
+TEST_CASE("Test 22: Instrumentation counters")
+{
+    stats::reset();
+    FractionCounters before = stats::snapshot();
+    CHECK(before.reductions == 0);
+
+    Fraction a(2, 4);
+    Fraction b(0.25f);
+    CHECK_THROWS(Fraction(1, 0));
+    CHECK(checked_mul(Fraction(65536, 1), Fraction(65536, 1)).error == FractionError::Overflow);
+
+    FractionCounters after = stats::snapshot();
+
+    if (stats::enabled())
+    {
+        CHECK(after.constructions >= 5);
+        CHECK(after.reductions >= 2);
+        CHECK(after.gcd_iterations >= after.reductions);
+        CHECK(after.float_conversions == 1);
+        CHECK(after.float_iterations == 2);
+        CHECK(after.exceptions == 1);
+        CHECK(after.overflows == 1);
+        CHECK(stats::snapshot_all().constructions >= after.constructions);
+    }
+
+    else
+    {
+        CHECK(after.constructions == 0);
+        CHECK(stats::snapshot_all().reductions == 0);
+    }
+
+    stats::reset();
+    CHECK(stats::snapshot().constructions == 0);
+}
+
+TEST_CASE("Test 23: Latency histograms")
+{
+    metrics::reset();
+
+    // Every latency falls in a bucket whose limit covers it, and the buckets are ordered.
+    for (uint64_t value : {0ull, 1ull, 3ull, 4ull, 5ull, 7ull, 8ull, 100ull, 1000ull, 123456789ull})
+    {
+        unsigned int index = metrics::bucket(value);
+        CHECK(value <= metrics::bucket_limit(index));
+        CHECK((index == 0 || value > metrics::bucket_limit(index - 1)));
+    }
+
+    CHECK(metrics::bucket(UINT64_MAX) == metrics::BUCKETS - 1);
+
+    metrics::record(metrics::add, 150);
+    metrics::record(metrics::add, 250);
+    CHECK(metrics::count(metrics::add) == 2);
+    CHECK(metrics::count(metrics::mul) == 0);
+
+    unsigned int interval = metrics::sample_interval();
+    metrics::set_sample_interval(1);
+
+    Fraction a(1, 3), b(1, 6);
+    CHECK(a * b == Fraction(1, 18));
+
+    if (metrics::enabled())
+    {
+        CHECK(metrics::count(metrics::construct) >= 3);
+        CHECK(metrics::count(metrics::mul) == 1);
+        CHECK(metrics::count(metrics::compare) == 1);
+    }
+
+    else
+        CHECK(metrics::count(metrics::mul) == 0);
+
+    metrics::set_sample_interval(interval);
+
+    ostringstream os;
+    metrics::dump_prometheus(os);
+    CHECK(os.str().find("# TYPE fraction_operation_latency_seconds histogram") != string::npos);
+    CHECK(os.str().find("fraction_operation_latency_seconds_count{op=\"add\"} 2") != string::npos);
+    CHECK(os.str().find("fraction_operation_latency_seconds_bucket{op=\"add\",le=\"+Inf\"} 2") != string::npos);
+
+    // The bounds don't depend on the format of the stream, and the clamped last bucket is only +Inf.
+    metrics::record(metrics::div, UINT64_MAX / 2);
+    ostringstream formatted;
+    formatted << fixed << setprecision(2);
+    metrics::dump_prometheus(formatted);
+    CHECK(formatted.str().find("le=\"2.55e-07\"") != string::npos);
+    CHECK(formatted.str().find("le=\"1099.511627775\"") != string::npos);
+    CHECK(formatted.str().find("le=\"2199.023255551\"") == string::npos);
+    CHECK(formatted.str().find("fraction_operation_latency_seconds_bucket{op=\"div\",le=\"+Inf\"} 1") != string::npos);
+    CHECK(formatted.precision() == 2);
+
+    metrics::reset();
+    CHECK(metrics::count(metrics::add) == 0);
+
+    // Every family keeps its own countdown, so alternating families are each sampled at the interval.
+    metrics::set_sample_interval(2);
+
+    for (int i = 0; i < 4; i++)
+    {
+        {
+            metrics::ScopedTimer timer(metrics::add);
+        }
+
+        {
+            metrics::ScopedTimer timer(metrics::compare);
+        }
+    }
+
+    CHECK(metrics::count(metrics::add) == 2);
+    CHECK(metrics::count(metrics::compare) == 2);
+
+    metrics::set_sample_interval(interval);
+    metrics::reset();
+}
+
+TEST_CASE("Test 24: Static probes")
+{
+#if __has_include(<sys/sdt.h>) && !defined(FRACTION_NO_PROBES)
+    CHECK(probes::enabled());
+#else
+    CHECK_FALSE(probes::enabled());
+#endif
+
+    // The probed paths behave the same with or without the tracepoints.
+    stringstream stream;
+    stream << Fraction(0.75f);
+    CHECK(stream.str() == "3/4");
+
+    Fraction a;
+    stream >> a;
+    CHECK(a == Fraction(3, 4));
+}
+
+TEST_CASE("Test 25: Packed bits and AtomicFraction")
+{
+    Fraction a(-3, 4);
+    CHECK(to_bits(a) == 0xFFFFFFFD00000004ull);
+    CHECK(from_bits(to_bits(a)) == a);
+    CHECK(from_bits(to_bits(Fraction(2147483647, 1))) == Fraction(2147483647, 1));
+    CHECK_THROWS_AS(from_bits(0x0000000100000000ull), invalid_argument);
+
+    AtomicFraction value(Fraction(1, 2));
+    CHECK(value.load() == Fraction(1, 2));
+    CHECK(noexcept(value.load()));
+    CHECK(noexcept(value.exchange(a)));
+    CHECK(noexcept(Fraction(value)));
+    CHECK(value.fetch_add(Fraction(1, 3)) == Fraction(1, 2));
+    CHECK(value.fetch_mul(Fraction(6, 5)) == Fraction(5, 6));
+    CHECK(value.load() == 1);
+
+    Fraction expected(1, 2);
+    CHECK_FALSE(value.compare_exchange(expected, Fraction(7, 8)));
+    CHECK(expected == 1);
+    CHECK(value.compare_exchange(expected, Fraction(7, 8)));
+    CHECK_FALSE(value.compare_exchange(expected, Fraction(1, 8), std::memory_order_acq_rel));
+    CHECK(value.compare_exchange(expected, Fraction(1, 8), std::memory_order_release));
+    CHECK_FALSE(value.compare_exchange(expected, Fraction(7, 8), std::memory_order_acq_rel, std::memory_order_acquire));
+    CHECK(expected == Fraction(1, 8));
+    CHECK(value.compare_exchange(expected, Fraction(7, 8), std::memory_order_acq_rel, std::memory_order_acquire));
+    CHECK(value.fetch_add(Fraction(0), std::memory_order_release) == Fraction(7, 8));
+    CHECK(value.exchange(Fraction(0)) == Fraction(7, 8));
+
+    // An overflowing update throws and leaves the value unchanged.
+    value.store(Fraction(65536, 1));
+    CHECK_THROWS_AS(value.fetch_mul(Fraction(65536, 1)), overflow_error);
+    CHECK(value.load() == 65536);
+
+    // Concurrent updates are never lost.
+    value.store(Fraction(0));
+    vector<thread> threads;
+
+    for (int i = 0; i < 4; i++)
+        threads.emplace_back([&value]() {
+            for (int j = 0; j < 1000; j++)
+                value.fetch_add(Fraction(1, 4));
+        });
+
+    for (thread& t : threads)
+        t.join();
+
+    CHECK(value.load() == 1000);
+}
+
+TEST_CASE("Test 26: Concurrent fraction sum")
+{
+    ConcurrentFractionSum sum(4);
+    CHECK(sum.shards() == 4);
+    CHECK(sum.result() == 0);
+
+    sum += Fraction(1, 2);
+    sum += Fraction(1, 3);
+    CHECK(sum.result() == Fraction(5, 6));
+
+    // Many threads over a few shards, with different denominators.
+    sum.reset();
+    vector<thread> threads;
+
+    for (int i = 0; i < 8; i++)
+        threads.emplace_back([&sum, i]() {
+            for (int j = 0; j < 1000; j++)
+                sum.add(Fraction(1, (i % 4) + 2));
+        });
+
+    for (thread& t : threads)
+        t.join();
+
+    // 2000 * (1/2 + 1/3 + 1/4 + 1/5)
+    CHECK(sum.count() == 8000);
+    CHECK(sum.result() == Fraction(7700, 3));
+
+    // The partials grow past an int, only the merged sum has to fit.
+    sum.reset();
+    sum += Fraction(2147483647, 1);
+    sum += Fraction(2147483647, 1);
+    sum += Fraction(-2147483647, 1);
+    CHECK(sum.result() == Fraction(2147483647, 1));
+    sum += Fraction(1, 1);
+    CHECK_THROWS_AS(sum.result(), overflow_error);
+}
+
+TEST_CASE("Test 27: SmallFraction")
+{
+    CHECK(sizeof(SmallFraction) == 4);
+
+    SmallFraction a(2, -4), b(Fraction(1, 3));
+    CHECK(a.numerator() == -1);
+    CHECK(a.denominator() == 2);
+    CHECK(Fraction(a) == Fraction(-1, 2));
+
+    // The largest values still fit, one past them doesn't.
+    CHECK(SmallFraction(32767, 65535).denominator() == 65535);
+    CHECK_THROWS_AS(SmallFraction(32768, 1), overflow_error);
+    CHECK_THROWS_AS(SmallFraction(1, 65536), overflow_error);
+    CHECK_THROWS_AS(SmallFraction(1, 0), invalid_argument);
+
+    // Arithmetic promotes to Fraction, so results past 16 bits are kept.
+    CHECK(a + b == Fraction(-1, 6));
+    CHECK(a * b == Fraction(-1, 6));
+    CHECK(SmallFraction(30000, 1) + SmallFraction(30000, 1) == 60000);
+    CHECK(SmallFraction(1, 30000) * SmallFraction(1, 30000) == Fraction(1, 900000000));
+    CHECK_THROWS_AS(a / SmallFraction(), invalid_argument);
+
+    // Members near the 16 bit limits: the cross products don't fit in an int.
+    CHECK(SmallFraction(-32768, 65535) - SmallFraction(32767, 65535) == Fraction(-1, 1));
+    CHECK(SmallFraction(32767, 2) / SmallFraction(1, 65535) == Fraction(2147385345, 2));
+    CHECK(SmallFraction(-32768, 1) * SmallFraction(-32768, 1) == Fraction(1073741824, 1));
+    CHECK_THROWS_AS(SmallFraction(1, 65535) + SmallFraction(1, 65534), overflow_error);
+    CHECK_THROWS_AS(SmallFraction(32767, 65535) * SmallFraction(32767, 65533), overflow_error);
+
+    CHECK(a < b);
+    CHECK(SmallFraction(-32768, 1) < SmallFraction(32767, 65535));
+    CHECK(SmallFraction(2, 4) == SmallFraction(1, 2));
+
+    ostringstream os;
+    os << a;
+    CHECK(os.str() == "-1/2");
+}
+
+TEST_CASE("Test 28: FixedFraction")
+{
+    using Milli = FixedFraction<1000>;
+
+    Milli a(Fraction(1, 4)), b(Fraction(3, 8));
+    CHECK(a.raw() == 250);
+    CHECK(b.raw() == 375);
+    CHECK(Fraction(a + b) == Fraction(5, 8));
+    CHECK(Fraction(a - b) == Fraction(-1, 8));
+    CHECK(Fraction(Milli(2)) == 2);
+
+    // Multiplication and division round to the nearest thousandth.
+    CHECK((a * b).raw() == 94);
+    CHECK((-a * b).raw() == -94);
+    CHECK((Milli(1) / Milli(3)).raw() == 333);
+    CHECK((Milli(2) / Milli(3)).raw() == 667);
+    CHECK((Milli(1) / -Milli(3)).raw() == -333);
+    CHECK_THROWS_AS(a / Milli(), invalid_argument);
+
+    // Only multiples of 1/D convert exactly.
+    CHECK_THROWS_AS(Milli(Fraction(1, 3)), invalid_argument);
+    CHECK(Fraction(FixedFraction<48000>(Fraction(1, 3))) == Fraction(1, 3));
+
+    CHECK_THROWS_AS(Milli::from_raw(2147483647) + Milli::from_raw(1), overflow_error);
+    CHECK(a < b);
+    CHECK(Milli(Fraction(2, 8)) == a);
+}
+
+TEST_CASE("Test 29: CommonDenominatorVector")
+{
+    vector<Fraction> fractions = {Fraction(1, 2), Fraction(1, 3), Fraction(-5, 6), Fraction(0)};
+    CommonDenominatorVector a(fractions);
+    CHECK(a.size() == 4);
+    CHECK(a.denominator() == 6);
+    CHECK(a.numerators()[1] == 2);
+    CHECK(a.to_vector() == fractions);
+
+    // Same denominator: element-wise integer add.
+    CommonDenominatorVector b = a + a;
+    CHECK(b.denominator() == 6);
+    CHECK(b[0] == 1);
+    CHECK(b[2] == Fraction(-5, 3));
+
+    // Different denominators: rescaled once to the LCM.
+    vector<Fraction> quarters(4, Fraction(1, 4));
+    CommonDenominatorVector c(quarters);
+    c -= a;
+    CHECK(c.denominator() == 12);
+    CHECK(c.to_vector() == vector<Fraction>{Fraction(-1, 4), Fraction(-1, 12), Fraction(13, 12), Fraction(1, 4)});
+
+    c.push_back(Fraction(1, 5));
+    CHECK(c.denominator() == 60);
+    CHECK(c[4] == Fraction(1, 5));
+
+    CommonDenominatorVector d(2, 10);
+    d.push_back(Fraction(1, 2));
+    d.reduce();
+    CHECK(d.denominator() == 2);
+    CHECK(d[2] == Fraction(1, 2));
+
+    CHECK_THROWS_AS(a += d, invalid_argument);
+    CHECK_THROWS_AS(CommonDenominatorVector(1, 0), invalid_argument);
+}
+
+TEST_CASE("Test 30: DyadicFraction")
+{
+    DyadicFraction a(6, 3), b(Fraction(-5, 16));
+    CHECK(a.numerator() == 3);
+    CHECK(a.exponent() == 2);
+    CHECK(b.exponent() == 4);
+
+    CHECK(a + b == DyadicFraction(7, 4));
+    CHECK(a - b == DyadicFraction(17, 4));
+    CHECK(a * b == DyadicFraction(-15, 6));
+    CHECK(a + DyadicFraction(1, 2) == DyadicFraction(1));
+    CHECK(Fraction(a * b) == Fraction(-15, 64));
+
+    CHECK(b < a);
+    CHECK(DyadicFraction(1, 62) > DyadicFraction(0));
+    CHECK(DyadicFraction(1LL << 60) > DyadicFraction(3, 62));
+
+    // Every finite double converts exactly.
+    CHECK(DyadicFraction::from_double(0.375) == DyadicFraction(3, 3));
+    CHECK(DyadicFraction::from_double(-1536.0) == DyadicFraction(-1536));
+    CHECK(DyadicFraction::from_double(0.1).to_double() == 0.1);
+    CHECK_THROWS_AS(DyadicFraction::from_double(1e300), overflow_error);
+
+    CHECK_THROWS_AS(DyadicFraction(Fraction(1, 3)), invalid_argument);
+    CHECK_THROWS_AS(DyadicFraction(1, 63), invalid_argument);
+    CHECK_THROWS_AS(DyadicFraction(1, 40) * DyadicFraction(1, 40), overflow_error);
+    CHECK_THROWS_AS(Fraction(DyadicFraction(1, 31)), overflow_error);
+}
+
+TEST_CASE("Test 31: BoundedFraction and limit_denominator")
+{
+    // Best rational approximations of pi.
+    CHECK(limit_denominator(314159265, 100000000, 10) == Fraction(22, 7));
+    CHECK(limit_denominator(314159265, 100000000, 1000) == Fraction(355, 113));
+    CHECK(limit_denominator(-314159265, 100000000, 100) == Fraction(-311, 99));
+    CHECK(limit_denominator(Fraction(3, 8), 4) == Fraction(1, 3));
+    CHECK(limit_denominator(Fraction(3, 8), 8) == Fraction(3, 8));
+    CHECK(limit_denominator(1, 3, 1) == 0);
+    CHECK_THROWS_AS(limit_denominator(1, 0, 10), invalid_argument);
+    CHECK_THROWS_AS(limit_denominator(1LL << 40, 3, 1), overflow_error);
+    CHECK(limit_denominator(1, 3000000000LL, 4000000000LL) == Fraction(1, 2147483647));
+    CHECK(limit_denominator(7, 3000000001LL, 1LL << 40) > 0);
+    CHECK(limit_denominator(7, 3000000001LL, 1LL << 40).denominator() > 0);
+
+    using Small = BoundedFraction<100>;
+
+    Small a(1, 3), b(2, 7);
+    CHECK(Fraction(a + b) == Fraction(13, 21));
+    CHECK(Fraction(Small(1, 101)) == Fraction(1, 100));
+
+    // Repeated products keep the denominator bounded instead of overflowing.
+    Small x(99, 100);
+    FractionResult exact = Fraction::make(99, 100);
+
+    for (int i = 0; i < 20; i++)
+    {
+        x *= Small(99, 100);
+
+        if (exact)
+            exact = checked_mul(exact.value, Fraction(99, 100));
+    }
+
+    CHECK(x.denominator() <= 100);
+    CHECK(exact.error == FractionError::Overflow);
+    CHECK(x < Small(1));
+    CHECK(x > Small(7, 10));
+    CHECK_THROWS_AS(a / Small(), invalid_argument);
+}
+
+TEST_CASE("Test 32: ShadowedFraction")
+{
+    ShadowedFraction a(1, 3), b(Fraction(2, 7));
+    CHECK(a.to_double() == 1.0 / 3.0);
+    CHECK(b < a);
+    CHECK(a.compare(b) == 1);
+    CHECK(a.compare(ShadowedFraction(2, 6)) == 0);
+    CHECK(Fraction(a + b) == Fraction(13, 21));
+    CHECK((a * b).to_double() == 2.0 / 21.0);
+
+    // Neighbours with huge denominators are closer than the shadow error bound, the exact fallback still orders them.
+    ShadowedFraction e(2147483646, 2147483647), f(2147483645, 2147483646);
+    CHECK(e.to_double() - f.to_double() < 1e-15);
+    CHECK(f < e);
+    CHECK_FALSE(e < f);
+    CHECK(e != f);
+
+    vector<ShadowedFraction> values = {a, b, e, f, ShadowedFraction(-1, 2)};
+    sort(values.begin(), values.end());
+    CHECK(values.front() == ShadowedFraction(-1, 2));
+    CHECK(values.back() == e);
+}
+
+TEST_CASE("Test 33: Correctly rounded conversions")
+{
+    CHECK(Fraction(1, 3).to_double() == 1.0 / 3.0);
+    CHECK(Fraction(-7, 8).to_double() == -0.875);
+    CHECK(Fraction(1, 3).to_float() == 1.0f / 3.0f);
+    CHECK(Fraction().to_float() == 0.0f);
+    CHECK(Fraction(2147483647, 1).to_float() == 2147483648.0f);
+
+    // Just above the midpoint between 1 and the next float: the double quotient rounds onto the midpoint,
+    // so (float)to_double() rounds down to even, while the exact value rounds up.
+    Fraction above(1090519104, 1090519039);
+    CHECK(static_cast<float>(above.to_double()) == 1.0f);
+    CHECK(above.to_float() == nextafterf(1.0f, 2.0f));
+
+    // An exact midpoint rounds to even.
+    CHECK(Fraction(16777217, 16777216).to_float() == 1.0f);
+    CHECK(Fraction(-16777219, 16777216).to_float() == -1.0f - 0x1p-22f);
+
+    vector<Fraction> fractions(10000);
+
+    for (int i = 0; i < 10000; i++)
+        fractions[static_cast<size_t>(i)] = Fraction(i - 5000, i % 97 + 1);
+
+    vector<double> values(fractions.size());
+    to_double(fractions, values);
+
+    for (size_t i = 0; i < fractions.size(); i++)
+        CHECK(values[i] == fractions[i].to_double());
+
+    CHECK_THROWS_AS(to_double(fractions, span<double>(values).first(1)), invalid_argument);
+}
+
+TEST_CASE("Test 34: Batch conversion modes")
+{
+    vector<Fraction> fractions;
+
+    for (int i = 0; i < 20000; i++)
+        fractions.push_back(Fraction((i * 7919) % 200003 - 100000, i % 1013 + 1));
+
+    // The midpoint case of Test 33 takes the fix-up path.
+    fractions.push_back(Fraction(1090519104, 1090519039));
+    fractions.push_back(Fraction(2147483647, 2147483646));
+
+    vector<double> doubles(fractions.size()), fast_doubles(fractions.size());
+    vector<float> floats(fractions.size()), fast_floats(fractions.size());
+
+    to_double(fractions, doubles, ConversionMode::Exact);
+    to_double(fractions, fast_doubles, ConversionMode::Fast);
+    to_float(fractions, floats);
+    to_float(fractions, fast_floats, ConversionMode::Fast);
+
+    for (size_t i = 0; i < fractions.size(); i++)
+    {
+        CHECK(doubles[i] == fractions[i].to_double());
+        CHECK(floats[i] == fractions[i].to_float());
+        CHECK(fabs(fast_doubles[i] - doubles[i]) <= fabs(doubles[i]) * 1e-15);
+        CHECK(fabs(fast_floats[i] - floats[i]) <= fabs(floats[i]) * 1e-6f);
+    }
+
+    CHECK(floats[20000] == nextafterf(1.0f, 2.0f));
+    CHECK_THROWS_AS(to_float(fractions, span<float>(floats).first(3)), invalid_argument);
+}
+
+TEST_CASE("Test 35: Batch float to fraction conversion")
+{
+    vector<float> floats;
+
+    for (int i = 0; i < 20000; i++)
+        floats.push_back(static_cast<float>((i * 7919) % 200003 - 100000) / static_cast<float>(i % 1013 + 1));
+
+    // Integral, large and sub-thousandth values take the other selections.
+    floats.push_back(16777216.0f);
+    floats.push_back(2147483520.0f);
+    floats.push_back(-0.0001f);
+
+    vector<Fraction> decimal(floats.size());
+    from_float(floats, decimal);
+
+    for (size_t i = 0; i < floats.size(); i++)
+        CHECK(decimal[i] == Fraction(floats[i]));
+
+    vector<double> doubles = {0.1, 3.14159265, -2.5};
+    vector<Fraction> out(doubles.size());
+
+    from_double(doubles, out, FloatConversion::Bounded, 1000);
+    CHECK(out[0] == Fraction(1, 10));
+    CHECK(out[1] == Fraction(355, 113));
+    CHECK(out[2] == Fraction(-5, 2));
+
+    vector<float> exact = {0.1f, -0.75f};
+    from_float(exact, span<Fraction>(out).first(2), FloatConversion::Exact);
+    CHECK(out[0] == Fraction(13421773, 134217728));
+    CHECK(out[1] == Fraction(-3, 4));
+
+    vector<float> invalid = {1.0f, NAN};
+    vector<float> huge = {1e10f};
+    CHECK_THROWS_AS(from_float(floats, span<Fraction>(out).first(1)), invalid_argument);
+    CHECK_THROWS_AS(from_float(invalid, span<Fraction>(out).first(2)), invalid_argument);
+    CHECK_THROWS_AS(from_float(huge, span<Fraction>(out).first(1), FloatConversion::Exact), overflow_error);
+    CHECK_THROWS_AS(from_float(exact, span<Fraction>(out).first(2), FloatConversion::Bounded, 0), invalid_argument);
+}
+
+TEST_CASE("Test 36: Simplest fraction in an interval")
+{
+    CHECK(Fraction::simplest_between(Fraction(314159, 100000), Fraction(314160, 100000)) == Fraction(355, 113));
+    CHECK(Fraction::simplest_between(Fraction(1, 3), Fraction(2, 3)) == Fraction(1, 2));
+    CHECK(Fraction::simplest_between(Fraction(1, 3), Fraction(1, 3)) == Fraction(1, 3));
+    CHECK(Fraction::simplest_between(Fraction(5, 2), Fraction(7, 2)) == Fraction(3, 1));
+    CHECK(Fraction::simplest_between(Fraction(-1, 2), Fraction(1, 3)) == Fraction(0, 1));
+    CHECK(Fraction::simplest_between(Fraction(-2, 3), Fraction(-1, 3)) == Fraction(-1, 2));
+
+    // Bounds whose cross products overflow an int.
+    CHECK(Fraction::simplest_between(Fraction(2147483646, 2147483647), Fraction(2147483647, 2147483646)) == Fraction(1, 1));
+    CHECK(Fraction::simplest_between(Fraction(1, 2147483647), Fraction(1, 2147483646)) == Fraction(1, 2147483646));
+
+    // Agrees with trying every denominator.
+    for (int i = 1; i < 50; i++)
+    {
+        Fraction lo(i, 211), hi(i + 3, 223);
+        Fraction simplest = Fraction::simplest_between(lo, hi);
+
+        int denominator = 1;
+        while (static_cast<long long>((i * denominator + 210) / 211) * 223 > static_cast<long long>(i + 3) * denominator)
+            denominator++;
+
+        CHECK(simplest.denominator() == denominator);
+        CHECK(lo <= simplest);
+        CHECK(simplest <= hi);
+    }
+
+    CHECK_THROWS_AS(Fraction::simplest_between(Fraction(1, 2), Fraction(1, 3)), invalid_argument);
+}
+
+TEST_CASE("Test 37: Rounding, divmod and remainder")
+{
+    for (int numerator = -30; numerator <= 30; numerator++)
+    {
+        for (int denominator = 1; denominator <= 8; denominator++)
+        {
+            Fraction fraction(numerator, denominator);
+            double value = static_cast<double>(numerator) / denominator;
+
+            CHECK(floor(fraction) == static_cast<int>(std::floor(value)));
+            CHECK(ceil(fraction) == static_cast<int>(std::ceil(value)));
+            CHECK(trunc(fraction) == static_cast<int>(std::trunc(value)));
+            CHECK(round(fraction) == static_cast<int>(std::round(value)));
+            CHECK(round(fraction, Rounding::HalfEven) == static_cast<int>(std::nearbyint(value)));
+            CHECK(frac(fraction) == fraction - Fraction(floor(fraction), 1));
+        }
+    }
+
+    CHECK(round(Fraction(5, 2), Rounding::HalfEven) == 2);
+    CHECK(round(Fraction(-5, 2), Rounding::HalfAway) == -3);
+    CHECK(floor(Fraction(-2147483647 - 1, 1)) == -2147483647 - 1);
+    CHECK(ceil(Fraction(-2147483647 - 1, 3)) == -715827882);
+    CHECK(Fraction(-2147483647 - 1, 4).denominator() == 1);
+    CHECK(Fraction(-2147483647 - 1, -2147483647 - 1) == 1);
+    CHECK(Fraction(0, -2147483647 - 1).denominator() == 1);
+    CHECK_THROWS_AS(Fraction(1, -2147483647 - 1), overflow_error);
+    CHECK_THROWS_AS(Fraction(-2147483647 - 1, -1), overflow_error);
+    CHECK(frac(Fraction(-7, 3)) == Fraction(2, 3));
+
+    FractionDivmod result = divmod(Fraction(7, 2), Fraction(2, 3));
+    CHECK(result.quotient == 5);
+    CHECK(result.remainder == Fraction(1, 6));
+
+    result = divmod(Fraction(-7, 2), Fraction(2, 3));
+    CHECK(result.quotient == -6);
+    CHECK(result.remainder == Fraction(1, 2));
+
+    CHECK(Fraction(7, 2) % Fraction(-2, 3) == Fraction(-1, 2));
+    CHECK(divmod(Fraction(2147483647, 1), Fraction(1, 2147483647)).quotient == 4611686014132420609LL);
+    CHECK_THROWS_AS(divmod(Fraction(1, 2), Fraction(0, 1)), invalid_argument);
+    CHECK_THROWS_AS(Fraction(1, 65537) % Fraction(1, 65539), overflow_error);
+}
+
+TEST_CASE("Test 38: Powers")
+{
+    CHECK(pow(Fraction(2, 3), 5) == Fraction(32, 243));
+    CHECK(pow(Fraction(-2, 3), 3) == Fraction(-8, 27));
+    CHECK(pow(Fraction(-2, 3), -3) == Fraction(-27, 8));
+    CHECK(pow(Fraction(2, 3), 0) == Fraction(1, 1));
+    CHECK(pow(Fraction(0, 1), 0) == Fraction(1, 1));
+    CHECK(pow(Fraction(1, 2), 30) == Fraction(1, 1073741824));
+    CHECK(pow(Fraction(-1, 1), -2147483647 - 1) == Fraction(1, 1));
+
+    // Agrees with repeated multiplication.
+    Fraction power(1, 1);
+
+    for (int exponent = 1; exponent <= 13; exponent++)
+    {
+        power *= Fraction(-5, 4);
+        CHECK(pow(Fraction(-5, 4), exponent) == power);
+    }
+
+    CHECK_THROWS_AS(pow(Fraction(3, 2), 20), overflow_error);
+    CHECK_THROWS_AS(pow(Fraction(-2147483647 - 1, 1), -1), overflow_error);
+    CHECK_THROWS_AS(pow(Fraction(0, 1), -1), invalid_argument);
+
+    // 3/2 modulo 7 is 3 * 4 = 5, and 5^3 = 125 = 6 (mod 7).
+    CHECK(pow_mod(Fraction(3, 2), 3, 7) == 6);
+    CHECK(pow_mod(Fraction(3, 2), -1, 7) == 3);
+    CHECK(pow_mod(Fraction(-1, 1), 3, 7) == 6);
+    CHECK(pow_mod(Fraction(2, 1), 1000000007LL - 1, 1000000007LL) == 1);
+    CHECK(pow_mod(Fraction(5, 3), 0, 1) == 0);
+    CHECK_THROWS_AS(pow_mod(Fraction(1, 2), 1, 4), invalid_argument);
+    CHECK_THROWS_AS(pow_mod(Fraction(1, 2), 1, 0), invalid_argument);
+}
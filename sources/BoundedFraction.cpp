@@ -0,0 +1,130 @@
+/*
+ *  Software Systems CPP Course Assignment 3
+ *  Copyright (C) 2023  Roy Simanovich
+ * 
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ * 
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <https://www.gnu.org/licenses/>.
+*/
+
+#include <algorithm>
+#include <limits>
+#include <numeric>
+#include <stdexcept>
+#include "BoundedFraction.hpp"
+
+using namespace std;
+
+namespace ariel
+{
+    /*
+     * @brief A 128-bit signed integer, wide enough for the cross products of the approximation errors.
+    */
+    __extension__ typedef __int128 wide_t;
+
+    Fraction limit_denominator(long long numerator, long long denominator, long long max_denominator) {
+        if (denominator == 0 || max_denominator <= 0)
+        {
+            FRACTION_COUNT(exceptions);
+            throw invalid_argument((denominator == 0) ? "Denominator can't be zero" : "Maximal denominator must be positive");
+        }
+
+        // Work on a positive denominator and a non-negative numerator, the sign is restored at the end.
+        // Both are unsigned, so even LLONG_MIN has a magnitude.
+        bool negative = (numerator < 0) != (denominator < 0);
+        unsigned long long n = (numerator < 0) ? 0 - static_cast<unsigned long long>(numerator) : static_cast<unsigned long long>(numerator);
+        unsigned long long d = (denominator < 0) ? 0 - static_cast<unsigned long long>(denominator) : static_cast<unsigned long long>(denominator);
+        // A fraction can't hold a denominator past INT_MAX, so a larger limit is the same as INT_MAX.
+        unsigned long long max = static_cast<unsigned long long>(min<long long>(max_denominator, numeric_limits<int>::max()));
+
+        unsigned long long g = gcd(n, d);
+        n /= g;
+        d /= g;
+
+        unsigned long long p, q;
+
+        if (d <= max)
+        {
+            p = n;
+            q = d;
+        }
+
+        else
+        {
+            // Convergents p0/q0 and p1/q1 of the continued fraction of n/d.
+            unsigned long long p0 = 0, q0 = 1, p1 = 1, q1 = 0;
+            unsigned long long x = n, y = d;
+
+            while (y != 0)
+            {
+                unsigned long long a = x / y;
+
+                // Stop before the next convergent's denominator passes the limit.
+                if (q1 != 0 && a > (max - q0) / q1)
+                    break;
+
+                unsigned long long q2 = q0 + a * q1;
+
+                if (q2 > max)
+                    break;
+
+                unsigned long long p2 = p0 + a * p1;
+                p0 = p1;
+                q0 = q1;
+                p1 = p2;
+                q1 = q2;
+
+                unsigned long long r = x - a * y;
+                x = y;
+                y = r;
+            }
+
+            // The best semiconvergent below the limit, and the last convergent.
+            unsigned long long k = (max - q0) / q1;
+            unsigned long long sp = p0 + k * p1, sq = q0 + k * q1;
+
+            // Pick the closer one: |sp/sq - n/d| vs |p1/q1 - n/d|, compared as |sp*d - n*sq| * q1 vs |p1*d - n*q1| * sq.
+            wide_t semi_error = static_cast<wide_t>(sp) * d - static_cast<wide_t>(n) * sq;
+            wide_t convergent_error = static_cast<wide_t>(p1) * d - static_cast<wide_t>(n) * q1;
+            semi_error = (semi_error < 0) ? -semi_error : semi_error;
+            convergent_error = (convergent_error < 0) ? -convergent_error : convergent_error;
+
+            if (convergent_error * sq <= semi_error * q1)
+            {
+                p = p1;
+                q = q1;
+            }
+
+            else
+            {
+                p = sp;
+                q = sq;
+            }
+        }
+
+        if (p > static_cast<unsigned long long>(numeric_limits<int>::max()) + (negative ? 1 : 0))
+        {
+            FRACTION_COUNT(overflows);
+            FRACTION_COUNT(exceptions);
+            throw overflow_error("Approximation doesn't fit in a fraction");
+        }
+
+        long long signed_numerator = negative ? -static_cast<long long>(p) : static_cast<long long>(p);
+        return Fraction(static_cast<int>(signed_numerator), static_cast<int>(q));
+    }
+
+    Fraction limit_denominator(const Fraction& fraction, int max_denominator) {
+        if (fraction.denominator() <= max_denominator)
+            return fraction;
+
+        return limit_denominator(fraction.numerator(), fraction.denominator(), max_denominator);
+    }
+}
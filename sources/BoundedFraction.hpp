@@ -0,0 +1,163 @@
+/*
+ *  Software Systems CPP Course Assignment 3
+ *  Copyright (C) 2023  Roy Simanovich
+ * 
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ * 
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <https://www.gnu.org/licenses/>.
+*/
+
+#ifndef _BOUNDEDFRACTION_HPP
+#define _BOUNDEDFRACTION_HPP
+
+#include <iostream>
+#include <stdexcept>
+#include "Fraction.hpp"
+
+namespace ariel
+{
+    /*
+     * @brief Finds the closest fraction with a bounded denominator (best rational approximation).
+     * @param numerator The numerator of the value to approximate.
+     * @param denominator The denominator of the value to approximate (must not be 0).
+     * @param max_denominator The largest allowed denominator (must be positive, values past INT_MAX act as INT_MAX).
+     * @return Fraction The fraction with a denominator of at most max_denominator closest to numerator / denominator.
+     * @throw invalid_argument if the denominator is 0 or max_denominator isn't positive.
+     * @throw overflow_error if the numerator of the approximation doesn't fit in an int.
+     * @note Walks the continued fraction of the value and picks the better of the last convergent and the best semiconvergent.
+    */
+    Fraction limit_denominator(long long numerator, long long denominator, long long max_denominator);
+
+    /*
+     * @brief Finds the closest fraction with a bounded denominator (best rational approximation).
+     * @param fraction The fraction to approximate.
+     * @param max_denominator The largest allowed denominator (must be positive).
+     * @return Fraction The fraction with a denominator of at most max_denominator closest to the given one.
+    */
+    Fraction limit_denominator(const Fraction& fraction, int max_denominator);
+
+    /*
+     * @brief A fraction whose denominator never grows past MaxDen ("fixed-slash" arithmetic).
+     * @note Every operator computes the exact result in 64 bits and rounds it to the nearest fraction with a denominator of at most MaxDen.
+     * @note So unlike Fraction, repeated operations (e.g. *=) keep O(1) sized members instead of letting the denominator explode.
+     * @note Only values whose magnitude exceeds an int overflow.
+    */
+    template <int MaxDen> requires (MaxDen > 0)
+    class BoundedFraction
+    {
+        private:
+            /*
+             * @brief The value, reduced with a denominator of at most MaxDen.
+            */
+            Fraction _value;
+
+            /*
+             * @brief Rounds an exact wide result.
+            */
+            static BoundedFraction __round(long long numerator, long long denominator) {
+                BoundedFraction result;
+                result._value = limit_denominator(numerator, denominator, MaxDen);
+                return result;
+            }
+
+        public:
+            /*
+             * @brief The largest denominator.
+            */
+            static constexpr int max_denominator = MaxDen;
+
+            /*
+             * @brief Default constructor of the BoundedFraction class.
+             * @note The default fraction is 0/1.
+            */
+            BoundedFraction() noexcept {}
+
+            /*
+             * @brief Converts an integer.
+             * @param value The integer.
+            */
+            BoundedFraction(int value): _value(value, 1) {}
+
+            /*
+             * @brief Rounds a fraction to the nearest one with a denominator of at most MaxDen.
+             * @param fraction The fraction to round.
+            */
+            explicit BoundedFraction(const Fraction& fraction): _value(limit_denominator(fraction, MaxDen)) {}
+
+            /*
+             * @brief Rounds numerator / denominator to the nearest fraction with a denominator of at most MaxDen.
+             * @param numerator The numerator.
+             * @param denominator The denominator.
+             * @throw invalid_argument if the denominator is 0.
+            */
+            BoundedFraction(int numerator, int denominator): BoundedFraction(__round(numerator, denominator)) {}
+
+            int numerator() const { return _value.numerator(); }
+            int denominator() const { return _value.denominator(); }
+
+            /*
+             * @brief Returns the value as a Fraction.
+             * @return Fraction The value.
+            */
+            operator Fraction() const noexcept { return _value; }
+
+            BoundedFraction operator+(const BoundedFraction& other) const {
+                return __round(static_cast<long long>(numerator()) * other.denominator() + static_cast<long long>(other.numerator()) * denominator(),
+                               static_cast<long long>(denominator()) * other.denominator());
+            }
+
+            BoundedFraction operator-(const BoundedFraction& other) const {
+                return __round(static_cast<long long>(numerator()) * other.denominator() - static_cast<long long>(other.numerator()) * denominator(),
+                               static_cast<long long>(denominator()) * other.denominator());
+            }
+
+            BoundedFraction operator*(const BoundedFraction& other) const {
+                return __round(static_cast<long long>(numerator()) * other.numerator(), static_cast<long long>(denominator()) * other.denominator());
+            }
+
+            /*
+             * @throw invalid_argument if other is 0.
+            */
+            BoundedFraction operator/(const BoundedFraction& other) const {
+                return __round(static_cast<long long>(numerator()) * other.denominator(), static_cast<long long>(denominator()) * other.numerator());
+            }
+
+            BoundedFraction operator-() const { return __round(-static_cast<long long>(numerator()), denominator()); }
+
+            BoundedFraction& operator+=(const BoundedFraction& other) { return *this = *this + other; }
+            BoundedFraction& operator-=(const BoundedFraction& other) { return *this = *this - other; }
+            BoundedFraction& operator*=(const BoundedFraction& other) { return *this = *this * other; }
+            BoundedFraction& operator/=(const BoundedFraction& other) { return *this = *this / other; }
+
+            /*
+             * @brief Comparison operators (cross products in 64 bits, so they never overflow).
+            */
+            bool operator==(const BoundedFraction& other) const noexcept { return _value == other._value; }
+            bool operator!=(const BoundedFraction& other) const noexcept { return !(_value == other._value); }
+
+            bool operator<(const BoundedFraction& other) const noexcept {
+                return static_cast<long long>(numerator()) * other.denominator() < static_cast<long long>(other.numerator()) * denominator();
+            }
+
+            bool operator>(const BoundedFraction& other) const noexcept { return other < *this; }
+            bool operator<=(const BoundedFraction& other) const noexcept { return !(other < *this); }
+            bool operator>=(const BoundedFraction& other) const noexcept { return !(*this < other); }
+
+            /*
+             * @brief Prints the fraction (numerator/denominator).
+            */
+            friend std::ostream& operator<<(std::ostream& os, const BoundedFraction& fraction) {
+                return os << fraction._value;
+            }
+    };
+}
+
+#endif
@@ -0,0 +1,245 @@
+/*
+ *  Software Systems CPP Course Assignment 3
+ *  Copyright (C) 2023  Roy Simanovich
+ * 
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ * 
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <https://www.gnu.org/licenses/>.
+*/
+
+#include <numeric>
+#include <stdexcept>
+#include "CommonDenominatorVector.hpp"
+#include "Overflow.hpp"
+
+using namespace std;
+
+namespace ariel
+{
+    /*
+     * @brief Calculates the least common multiple of two positive numbers.
+     * @param a The first number.
+     * @param b The second number.
+     * @return long long The least common multiple.
+     * @throw overflow_error if the least common multiple doesn't fit in a long long.
+    */
+    static long long __lcm(long long a, long long b) {
+        long long lcm;
+
+        if (overflow::mul(a / gcd(a, b), b, lcm))
+        {
+            FRACTION_COUNT(overflows);
+            FRACTION_COUNT(exceptions);
+            throw overflow_error("Common denominator overflow");
+        }
+
+        return lcm;
+    }
+
+    /*
+     * @brief Reduces a wide fraction to a Fraction.
+     * @param numerator The numerator.
+     * @param denominator The denominator (must be positive).
+     * @return Fraction The reduced fraction.
+     * @throw overflow_error if the reduced fraction doesn't fit in a Fraction.
+    */
+    static Fraction __to_fraction(long long numerator, long long denominator) {
+        long long g = gcd(numerator, denominator);
+        numerator /= g;
+        denominator /= g;
+
+        if (!overflow::fits_int(numerator) || !overflow::fits_int(denominator))
+        {
+            FRACTION_COUNT(overflows);
+            FRACTION_COUNT(exceptions);
+            throw overflow_error("Vector element doesn't fit in a fraction");
+        }
+
+        return Fraction(static_cast<int>(numerator), static_cast<int>(denominator));
+    }
+
+    CommonDenominatorVector::CommonDenominatorVector(): _denominator(1) {}
+
+    CommonDenominatorVector::CommonDenominatorVector(size_t size, long long denominator): _denominator(denominator), _numerators(size, 0) {
+        if (denominator <= 0)
+        {
+            FRACTION_COUNT(exceptions);
+            throw invalid_argument("Denominator must be positive");
+        }
+    }
+
+    CommonDenominatorVector::CommonDenominatorVector(span<const Fraction> fractions): _denominator(1) {
+        for (const Fraction& fraction : fractions)
+            _denominator = __lcm(_denominator, fraction.denominator());
+
+        _numerators.reserve(fractions.size());
+
+        for (const Fraction& fraction : fractions)
+        {
+            long long numerator;
+
+            if (overflow::mul(static_cast<long long>(fraction.numerator()), _denominator / fraction.denominator(), numerator))
+            {
+                FRACTION_COUNT(overflows);
+                FRACTION_COUNT(exceptions);
+                throw overflow_error("Vector numerator overflow");
+            }
+
+            _numerators.push_back(numerator);
+        }
+    }
+
+    void CommonDenominatorVector::__rescale(long long denominator) {
+        if (denominator == _denominator)
+            return;
+
+        long long factor = denominator / _denominator;
+        vector<long long> numerators(_numerators.size());
+        bool overflowed = false;
+
+        for (size_t i = 0; i < numerators.size(); i++)
+            overflowed |= overflow::mul(_numerators[i], factor, numerators[i]);
+
+        if (overflowed)
+        {
+            FRACTION_COUNT(overflows);
+            FRACTION_COUNT(exceptions);
+            throw overflow_error("Vector numerator overflow");
+        }
+
+        _numerators = std::move(numerators);
+        _denominator = denominator;
+    }
+
+    void CommonDenominatorVector::__combine(const CommonDenominatorVector& other, bool subtract) {
+        if (other.size() != size())
+        {
+            FRACTION_COUNT(exceptions);
+            throw invalid_argument("Vectors have different sizes");
+        }
+
+        // The fast path: one denominator, so the loop is a plain integer add the compiler vectorizes.
+        if (other._denominator == _denominator)
+        {
+            vector<long long> numerators(_numerators.size());
+            unsigned long long overflowed = 0;
+
+            // Wrapping unsigned math with a sign-bit overflow test, instead of the overflow builtins, keeps the loops vectorizable.
+            if (subtract)
+            {
+                for (size_t i = 0; i < numerators.size(); i++)
+                {
+                    unsigned long long a = static_cast<unsigned long long>(_numerators[i]), b = static_cast<unsigned long long>(other._numerators[i]);
+                    unsigned long long difference = a - b;
+                    overflowed |= (a ^ b) & (a ^ difference);
+                    numerators[i] = static_cast<long long>(difference);
+                }
+            }
+
+            else
+            {
+                for (size_t i = 0; i < numerators.size(); i++)
+                {
+                    unsigned long long a = static_cast<unsigned long long>(_numerators[i]), b = static_cast<unsigned long long>(other._numerators[i]);
+                    unsigned long long sum = a + b;
+                    overflowed |= (a ^ sum) & (b ^ sum);
+                    numerators[i] = static_cast<long long>(sum);
+                }
+            }
+
+            if (overflowed >> 63)
+            {
+                FRACTION_COUNT(overflows);
+                FRACTION_COUNT(exceptions);
+                throw overflow_error("Vector numerator overflow");
+            }
+
+            _numerators = std::move(numerators);
+            return;
+        }
+
+        // Rescale both sides once to the LCM, then take the fast path.
+        long long denominator = __lcm(_denominator, other._denominator);
+
+        CommonDenominatorVector rescaled(other);
+        rescaled.__rescale(denominator);
+
+        CommonDenominatorVector self(*this);
+        self.__rescale(denominator);
+        self.__combine(rescaled, subtract);
+
+        *this = std::move(self);
+    }
+
+    Fraction CommonDenominatorVector::operator[](size_t index) const {
+        return __to_fraction(_numerators[index], _denominator);
+    }
+
+    vector<Fraction> CommonDenominatorVector::to_vector() const {
+        vector<Fraction> fractions;
+        fractions.reserve(_numerators.size());
+
+        for (long long numerator : _numerators)
+            fractions.push_back(__to_fraction(numerator, _denominator));
+
+        return fractions;
+    }
+
+    void CommonDenominatorVector::push_back(const Fraction& fraction) {
+        long long denominator = __lcm(_denominator, fraction.denominator());
+        long long numerator;
+
+        if (overflow::mul(static_cast<long long>(fraction.numerator()), denominator / fraction.denominator(), numerator))
+        {
+            FRACTION_COUNT(overflows);
+            FRACTION_COUNT(exceptions);
+            throw overflow_error("Vector numerator overflow");
+        }
+
+        __rescale(denominator);
+        _numerators.push_back(numerator);
+    }
+
+    void CommonDenominatorVector::reduce() {
+        long long g = _denominator;
+
+        for (size_t i = 0; i < _numerators.size() && g != 1; i++)
+            g = gcd(g, _numerators[i]);
+
+        if (g == 1)
+            return;
+
+        for (long long& numerator : _numerators)
+            numerator /= g;
+
+        _denominator /= g;
+    }
+
+    CommonDenominatorVector& CommonDenominatorVector::operator+=(const CommonDenominatorVector& other) {
+        __combine(other, false);
+        return *this;
+    }
+
+    CommonDenominatorVector& CommonDenominatorVector::operator-=(const CommonDenominatorVector& other) {
+        __combine(other, true);
+        return *this;
+    }
+
+    CommonDenominatorVector operator+(CommonDenominatorVector a, const CommonDenominatorVector& b) {
+        a += b;
+        return a;
+    }
+
+    CommonDenominatorVector operator-(CommonDenominatorVector a, const CommonDenominatorVector& b) {
+        a -= b;
+        return a;
+    }
+}
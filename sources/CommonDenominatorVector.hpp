@@ -0,0 +1,153 @@
+/*
+ *  Software Systems CPP Course Assignment 3
+ *  Copyright (C) 2023  Roy Simanovich
+ * 
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ * 
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <https://www.gnu.org/licenses/>.
+*/
+
+#ifndef _COMMONDENOMINATORVECTOR_HPP
+#define _COMMONDENOMINATORVECTOR_HPP
+
+#include <cstddef>
+#include <span>
+#include <vector>
+#include "Fraction.hpp"
+
+namespace ariel
+{
+    /*
+     * @brief A vector of fractions that share one denominator.
+     * @note Only the numerators are stored per element, so adding two vectors over the same denominator is a plain integer loop the compiler vectorizes.
+     * @note Vectors over different denominators are first rescaled to the LCM of the two denominators.
+     * @note The elements are not reduced; operator[] and to_vector() reduce on the way out.
+    */
+    class CommonDenominatorVector
+    {
+        private:
+            /*
+             * @brief The shared denominator (always positive).
+            */
+            long long _denominator;
+
+            /*
+             * @brief The numerators of the elements over _denominator.
+            */
+            std::vector<long long> _numerators;
+
+            /*
+             * @brief Rescales all the numerators to a multiple of the current denominator.
+             * @param denominator The new denominator (must be a multiple of the current one).
+             * @throw overflow_error if a numerator overflows (the vector is left unchanged).
+            */
+            void __rescale(long long denominator);
+
+            /*
+             * @brief Adds or subtracts another vector element-wise, over the LCM of the two denominators.
+             * @param other The other vector.
+             * @param subtract True to subtract, false to add.
+             * @throw invalid_argument if the vectors have different sizes.
+             * @throw overflow_error if the LCM or a numerator overflows (the values are left unchanged).
+            */
+            void __combine(const CommonDenominatorVector& other, bool subtract);
+
+        public:
+            /*
+             * @brief Constructs an empty vector over the denominator 1.
+            */
+            CommonDenominatorVector();
+
+            /*
+             * @brief Constructs a vector of zeros over a denominator.
+             * @param size The number of elements.
+             * @param denominator The shared denominator.
+             * @throw invalid_argument if the denominator isn't positive.
+            */
+            CommonDenominatorVector(std::size_t size, long long denominator);
+
+            /*
+             * @brief Converts fractions, over the LCM of their denominators.
+             * @param fractions The fractions to convert.
+             * @throw overflow_error if the LCM or a numerator over it overflows.
+            */
+            explicit CommonDenominatorVector(std::span<const Fraction> fractions);
+
+            /*
+             * @brief Returns the number of elements.
+             * @return std::size_t The number of elements.
+            */
+            std::size_t size() const { return _numerators.size(); }
+
+            /*
+             * @brief Returns the shared denominator.
+             * @return long long The shared denominator.
+            */
+            long long denominator() const { return _denominator; }
+
+            /*
+             * @brief Returns the numerators over the shared denominator.
+             * @return std::span<const long long> The numerators.
+            */
+            std::span<const long long> numerators() const { return _numerators; }
+
+            /*
+             * @brief Returns an element.
+             * @param index The index of the element (must be in range).
+             * @return Fraction The reduced element.
+             * @throw overflow_error if the reduced element doesn't fit in a Fraction.
+            */
+            Fraction operator[](std::size_t index) const;
+
+            /*
+             * @brief Converts all the elements.
+             * @return std::vector<Fraction> The reduced elements.
+             * @throw overflow_error if a reduced element doesn't fit in a Fraction.
+            */
+            std::vector<Fraction> to_vector() const;
+
+            /*
+             * @brief Appends a fraction, rescaling the vector if its denominator doesn't divide the shared one.
+             * @param fraction The fraction to append.
+             * @throw overflow_error if the LCM or a rescaled numerator overflows.
+            */
+            void push_back(const Fraction& fraction);
+
+            /*
+             * @brief Divides the denominator and all the numerators by their greatest common divisor.
+             * @note Keeps the numbers small after several rescales.
+            */
+            void reduce();
+
+            /*
+             * @brief Adds another vector element-wise.
+             * @param other The vector to add.
+             * @return CommonDenominatorVector& The vector.
+             * @throw invalid_argument if the vectors have different sizes.
+             * @throw overflow_error if a numerator overflows (the vector is left unchanged).
+            */
+            CommonDenominatorVector& operator+=(const CommonDenominatorVector& other);
+
+            /*
+             * @brief Subtracts another vector element-wise.
+             * @param other The vector to subtract.
+             * @return CommonDenominatorVector& The vector.
+             * @throw invalid_argument if the vectors have different sizes.
+             * @throw overflow_error if a numerator overflows (the vector is left unchanged).
+            */
+            CommonDenominatorVector& operator-=(const CommonDenominatorVector& other);
+
+            friend CommonDenominatorVector operator+(CommonDenominatorVector a, const CommonDenominatorVector& b);
+            friend CommonDenominatorVector operator-(CommonDenominatorVector a, const CommonDenominatorVector& b);
+    };
+}
+
+#endif
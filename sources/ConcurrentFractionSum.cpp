@@ -0,0 +1,175 @@
+/*
+ *  Software Systems CPP Course Assignment 3
+ *  Copyright (C) 2023  Roy Simanovich
+ * 
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ * 
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <https://www.gnu.org/licenses/>.
+*/
+
+#include <atomic>
+#include <limits>
+#include <numeric>
+#include <stdexcept>
+#include <thread>
+#include "ConcurrentFractionSum.hpp"
+#include "Overflow.hpp"
+
+using namespace std;
+
+namespace ariel
+{
+    /*
+     * @brief Hands out a distinct seed to every thread that adds to a sum.
+    */
+    static atomic<size_t> __next_seed(0);
+
+    /*
+     * @brief The shard seed of the calling thread (its shard is the seed modulo the number of shards).
+    */
+    static thread_local size_t __seed = __next_seed.fetch_add(1, memory_order_relaxed);
+
+    ConcurrentFractionSum::ConcurrentFractionSum(unsigned int shards) {
+        if (shards == 0)
+            shards = 2 * max(1u, thread::hardware_concurrency());
+
+        _size = shards;
+        _shards = make_unique<Shard[]>(_size);
+    }
+
+    bool ConcurrentFractionSum::__add(wide_t& numerator, long long& denominator, wide_t other_numerator, long long other_denominator) {
+        wide_t sum;
+
+        if (denominator == other_denominator)
+        {
+            if (overflow::add(numerator, other_numerator, sum))
+                return true;
+
+            numerator = sum;
+            return false;
+        }
+
+        long long g = gcd(denominator, other_denominator);
+        long long lcm;
+        wide_t left, right;
+
+        if (overflow::mul(denominator / g, other_denominator, lcm) || overflow::mul(numerator, static_cast<wide_t>(other_denominator / g), left)
+            || overflow::mul(other_numerator, static_cast<wide_t>(denominator / g), right) || overflow::add(left, right, sum))
+            return true;
+
+        numerator = sum;
+        denominator = lcm;
+        return false;
+    }
+
+    void ConcurrentFractionSum::__reduce(wide_t& numerator, long long& denominator) {
+        // The gcd divides the denominator, so it fits in a long long.
+        long long a = denominator;
+        long long b = static_cast<long long>(((numerator < 0) ? -numerator : numerator) % denominator);
+
+        while (b != 0)
+        {
+            long long t = a % b;
+            a = b;
+            b = t;
+        }
+
+        numerator /= a;
+        denominator /= a;
+    }
+
+    void ConcurrentFractionSum::add(const Fraction& fraction) {
+        Shard& shard = _shards[__seed % _size];
+        lock_guard<mutex> guard(shard.lock);
+
+        if (__add(shard.numerator, shard.denominator, fraction.numerator(), fraction.denominator()))
+        {
+            __reduce(shard.numerator, shard.denominator);
+
+            if (__add(shard.numerator, shard.denominator, fraction.numerator(), fraction.denominator()))
+            {
+                FRACTION_COUNT(overflows);
+                FRACTION_COUNT(exceptions);
+                throw overflow_error("Concurrent sum partial overflow");
+            }
+        }
+
+        shard.count++;
+    }
+
+    Fraction ConcurrentFractionSum::result() const {
+        wide_t numerator = 0;
+        long long denominator = 1;
+
+        for (size_t i = 0; i < _size; i++)
+        {
+            wide_t shard_numerator;
+            long long shard_denominator;
+
+            {
+                lock_guard<mutex> guard(_shards[i].lock);
+                shard_numerator = _shards[i].numerator;
+                shard_denominator = _shards[i].denominator;
+            }
+
+            if (__add(numerator, denominator, shard_numerator, shard_denominator))
+            {
+                __reduce(numerator, denominator);
+                __reduce(shard_numerator, shard_denominator);
+
+                if (__add(numerator, denominator, shard_numerator, shard_denominator))
+                {
+                    FRACTION_COUNT(overflows);
+                    FRACTION_COUNT(exceptions);
+                    throw overflow_error("Concurrent sum overflow");
+                }
+            }
+        }
+
+        __reduce(numerator, denominator);
+
+        if (numerator < numeric_limits<int>::min() || numerator > numeric_limits<int>::max() || denominator > numeric_limits<int>::max())
+        {
+            FRACTION_COUNT(overflows);
+            FRACTION_COUNT(exceptions);
+            throw overflow_error("Concurrent sum doesn't fit in a fraction");
+        }
+
+        return Fraction(static_cast<int>(numerator), static_cast<int>(denominator));
+    }
+
+    void ConcurrentFractionSum::reset() {
+        for (size_t i = 0; i < _size; i++)
+        {
+            lock_guard<mutex> guard(_shards[i].lock);
+            _shards[i].numerator = 0;
+            _shards[i].denominator = 1;
+            _shards[i].count = 0;
+        }
+    }
+
+    size_t ConcurrentFractionSum::count() const {
+        size_t count = 0;
+
+        for (size_t i = 0; i < _size; i++)
+        {
+            lock_guard<mutex> guard(_shards[i].lock);
+            count += _shards[i].count;
+        }
+
+        return count;
+    }
+
+    ConcurrentFractionSum& ConcurrentFractionSum::operator+=(const Fraction& fraction) {
+        add(fraction);
+        return *this;
+    }
+}
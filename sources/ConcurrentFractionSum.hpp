@@ -0,0 +1,129 @@
+/*
+ *  Software Systems CPP Course Assignment 3
+ *  Copyright (C) 2023  Roy Simanovich
+ * 
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ * 
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <https://www.gnu.org/licenses/>.
+*/
+
+#ifndef _CONCURRENTFRACTIONSUM_HPP
+#define _CONCURRENTFRACTIONSUM_HPP
+
+#include <cstddef>
+#include <memory>
+#include <mutex>
+#include "Fraction.hpp"
+
+namespace ariel
+{
+    /*
+     * @brief An exact sum of fractions that many threads add to at the same time.
+     * @note Every thread adds to one of several shards, each on its own cache line, so the threads don't contend on a single word.
+     * @note A shard holds its partial sum over a common denominator with a 128-bit numerator; nothing is reduced until it would overflow.
+     * @note result() merges the shards exactly.
+    */
+    class ConcurrentFractionSum
+    {
+        private:
+            __extension__ typedef __int128 wide_t;
+
+            /*
+             * @brief A partial sum, padded to a cache line so neighbouring shards don't false share.
+            */
+            struct alignas(64) Shard
+            {
+                std::mutex lock;
+                wide_t numerator = 0;
+                long long denominator = 1;
+                std::size_t count = 0;
+            };
+
+            /*
+             * @brief The shards.
+            */
+            std::unique_ptr<Shard[]> _shards;
+
+            /*
+             * @brief The number of shards.
+            */
+            std::size_t _size;
+
+            /*
+             * @brief Adds a fraction to a partial sum over the LCM of the denominators.
+             * @param numerator The numerator of the partial sum.
+             * @param denominator The denominator of the partial sum.
+             * @param other_numerator The numerator to add.
+             * @param other_denominator The denominator to add (must be positive).
+             * @return True on overflow (the partial sum is left unchanged), false otherwise.
+            */
+            static bool __add(wide_t& numerator, long long& denominator, wide_t other_numerator, long long other_denominator);
+
+            /*
+             * @brief Reduces a partial sum.
+             * @param numerator The numerator of the partial sum.
+             * @param denominator The denominator of the partial sum.
+            */
+            static void __reduce(wide_t& numerator, long long& denominator);
+
+        public:
+            /*
+             * @brief Constructs an empty sum.
+             * @param shards The number of shards (0 means two per hardware thread).
+            */
+            explicit ConcurrentFractionSum(unsigned int shards = 0);
+
+            ConcurrentFractionSum(const ConcurrentFractionSum& other) = delete;
+            ConcurrentFractionSum& operator=(const ConcurrentFractionSum& other) = delete;
+
+            /*
+             * @brief Adds a fraction to the sum.
+             * @param fraction The fraction to add.
+             * @throw overflow_error if the partial sum of the calling thread's shard overflows even after reduction.
+             * @note Safe to call from any number of threads.
+            */
+            void add(const Fraction& fraction);
+
+            /*
+             * @brief Returns the exact sum of all the fractions added so far.
+             * @return Fraction The reduced sum.
+             * @throw overflow_error if the sum doesn't fit in a Fraction.
+             * @note Concurrent adds are either fully included or not at all.
+            */
+            Fraction result() const;
+
+            /*
+             * @brief Clears the sum.
+            */
+            void reset();
+
+            /*
+             * @brief Returns the number of fractions added so far.
+             * @return std::size_t The number of fractions added so far.
+            */
+            std::size_t count() const;
+
+            /*
+             * @brief Returns the number of shards.
+             * @return std::size_t The number of shards.
+            */
+            std::size_t shards() const { return _size; }
+
+            /*
+             * @brief Adds a fraction to the sum.
+             * @param fraction The fraction to add.
+             * @return ConcurrentFractionSum& The sum.
+            */
+            ConcurrentFractionSum& operator+=(const Fraction& fraction);
+    };
+}
+
+#endif
@@ -0,0 +1,202 @@
+/*
+ *  Software Systems CPP Course Assignment 3
+ *  Copyright (C) 2023  Roy Simanovich
+ * 
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ * 
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <https://www.gnu.org/licenses/>.
+*/
+
+#include <bit>
+#include <cmath>
+#include <limits>
+#include <stdexcept>
+#include "DyadicFraction.hpp"
+#include "Overflow.hpp"
+
+using namespace std;
+
+namespace ariel
+{
+    /*
+     * @brief A 128-bit signed integer, wide enough for a long long shifted by up to 62 bits.
+    */
+    __extension__ typedef __int128 wide_t;
+
+    /*
+     * @brief Throws the overflow error of the dyadic operations.
+    */
+    [[noreturn]] static void __overflow() {
+        FRACTION_COUNT(overflows);
+        FRACTION_COUNT(exceptions);
+        throw overflow_error("Dyadic fraction overflow");
+    }
+
+    /*
+     * @brief Shifts a numerator left, checking for overflow.
+     * @param numerator The numerator to shift.
+     * @param shift The number of bits to shift by (0 to MAX_EXPONENT).
+     * @return long long The shifted numerator.
+     * @throw overflow_error if the shifted numerator doesn't fit in a long long.
+    */
+    static long long __shift(long long numerator, int shift) {
+        wide_t shifted = static_cast<wide_t>(numerator) * (static_cast<wide_t>(1) << shift);
+
+        if (shifted < numeric_limits<long long>::min() || shifted > numeric_limits<long long>::max())
+            __overflow();
+
+        return static_cast<long long>(shifted);
+    }
+
+    void DyadicFraction::__reduce() noexcept {
+        if (_numerator == 0)
+        {
+            _exponent = 0;
+            return;
+        }
+
+        int shift = min(countr_zero(static_cast<unsigned long long>(_numerator)), _exponent);
+        _numerator >>= shift;
+        _exponent -= shift;
+    }
+
+    DyadicFraction::DyadicFraction(long long numerator, int exponent): _numerator(numerator), _exponent(exponent) {
+        if (exponent < 0 || exponent > MAX_EXPONENT)
+        {
+            FRACTION_COUNT(exceptions);
+            throw invalid_argument("Exponent out of range");
+        }
+
+        __reduce();
+    }
+
+    DyadicFraction::DyadicFraction(const Fraction& fraction): _numerator(fraction.numerator()), _exponent(0) {
+        unsigned int denominator = static_cast<unsigned int>(fraction.denominator());
+
+        if (!has_single_bit(denominator))
+        {
+            FRACTION_COUNT(exceptions);
+            throw invalid_argument("Denominator isn't a power of two");
+        }
+
+        // Fractions are reduced, so the numerator is already odd unless the denominator is 1.
+        _exponent = countr_zero(denominator);
+    }
+
+    DyadicFraction DyadicFraction::from_double(double value) {
+        if (!isfinite(value))
+        {
+            FRACTION_COUNT(exceptions);
+            throw invalid_argument("Value isn't finite");
+        }
+
+        // value = mantissa * 2^exponent, with an integral 53 bit mantissa.
+        int exponent;
+        double mantissa = frexp(value, &exponent);
+        long long numerator = static_cast<long long>(ldexp(mantissa, 53));
+        exponent -= 53;
+
+        if (numerator == 0)
+            return DyadicFraction();
+
+        // Drop the trailing zero bits first, so only the significant bits limit the range.
+        int zeros = countr_zero(static_cast<unsigned long long>(numerator));
+        numerator >>= zeros;
+        exponent += zeros;
+
+        if (exponent > MAX_EXPONENT || -exponent > MAX_EXPONENT)
+            __overflow();
+
+        if (exponent >= 0)
+            return DyadicFraction(__shift(numerator, exponent));
+
+        return DyadicFraction(numerator, -exponent);
+    }
+
+    DyadicFraction::operator Fraction() const {
+        if (!overflow::fits_int(_numerator) || _exponent > 30)
+            __overflow();
+
+        return Fraction(static_cast<int>(_numerator), 1 << _exponent);
+    }
+
+    double DyadicFraction::to_double() const {
+        return ldexp(static_cast<double>(_numerator), -_exponent);
+    }
+
+    DyadicFraction operator+(const DyadicFraction& a, const DyadicFraction& b) {
+        int exponent = max(a._exponent, b._exponent);
+        long long sum;
+
+        if (overflow::add(__shift(a._numerator, exponent - a._exponent), __shift(b._numerator, exponent - b._exponent), sum))
+            __overflow();
+
+        return DyadicFraction(sum, exponent);
+    }
+
+    DyadicFraction operator-(const DyadicFraction& a, const DyadicFraction& b) {
+        int exponent = max(a._exponent, b._exponent);
+        long long difference;
+
+        if (overflow::sub(__shift(a._numerator, exponent - a._exponent), __shift(b._numerator, exponent - b._exponent), difference))
+            __overflow();
+
+        return DyadicFraction(difference, exponent);
+    }
+
+    DyadicFraction operator*(const DyadicFraction& a, const DyadicFraction& b) {
+        long long product;
+
+        if (overflow::mul(a._numerator, b._numerator, product) || a._exponent + b._exponent > DyadicFraction::MAX_EXPONENT)
+            __overflow();
+
+        return DyadicFraction(product, a._exponent + b._exponent);
+    }
+
+    DyadicFraction DyadicFraction::operator-() const {
+        if (_numerator == numeric_limits<long long>::min())
+            __overflow();
+
+        return DyadicFraction(-_numerator, _exponent);
+    }
+
+    bool operator==(const DyadicFraction& a, const DyadicFraction& b) noexcept {
+        return a._numerator == b._numerator && a._exponent == b._exponent;
+    }
+
+    bool operator!=(const DyadicFraction& a, const DyadicFraction& b) noexcept {
+        return !(a == b);
+    }
+
+    bool operator<(const DyadicFraction& a, const DyadicFraction& b) noexcept {
+        // The exponents differ by at most 62 bits, so the aligned numerators always fit in 128 bits.
+        int exponent = max(a._exponent, b._exponent);
+        return static_cast<wide_t>(a._numerator) * (static_cast<wide_t>(1) << (exponent - a._exponent))
+             < static_cast<wide_t>(b._numerator) * (static_cast<wide_t>(1) << (exponent - b._exponent));
+    }
+
+    bool operator>(const DyadicFraction& a, const DyadicFraction& b) noexcept {
+        return b < a;
+    }
+
+    bool operator<=(const DyadicFraction& a, const DyadicFraction& b) noexcept {
+        return !(b < a);
+    }
+
+    bool operator>=(const DyadicFraction& a, const DyadicFraction& b) noexcept {
+        return !(a < b);
+    }
+
+    ostream& operator<<(ostream& os, const DyadicFraction& fraction) {
+        os << fraction._numerator << "/" << (1ull << fraction._exponent);
+        return os;
+    }
+}
@@ -0,0 +1,136 @@
+/*
+ *  Software Systems CPP Course Assignment 3
+ *  Copyright (C) 2023  Roy Simanovich
+ * 
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ * 
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <https://www.gnu.org/licenses/>.
+*/
+
+#ifndef _DYADICFRACTION_HPP
+#define _DYADICFRACTION_HPP
+
+#include <iostream>
+#include "Fraction.hpp"
+
+namespace ariel
+{
+    /*
+     * @brief A fraction whose denominator is a power of two: numerator / 2^exponent.
+     * @note Addition, multiplication and comparison are shifts and integer operations, and reduction is a count of trailing zeros instead of a GCD.
+     * @note Like Fraction, it is always reduced: the numerator is odd, or the exponent is 0.
+     * @note Division isn't provided, since a quotient of dyadic fractions generally isn't dyadic; convert to Fraction for it.
+    */
+    class DyadicFraction
+    {
+        private:
+            /*
+             * @brief The numerator of the fraction.
+            */
+            long long _numerator;
+
+            /*
+             * @brief The power of two of the denominator, between 0 and MAX_EXPONENT.
+            */
+            int _exponent;
+
+            /*
+             * @brief Reduces the fraction by shifting out the common factors of two.
+             * @note Used internally after every operation.
+            */
+            void __reduce() noexcept;
+
+        public:
+            /*
+             * @brief The largest exponent, so the denominator fits in a long long.
+            */
+            static const int MAX_EXPONENT = 62;
+
+            /*
+             * @brief Constructs the fraction numerator / 2^exponent.
+             * @param numerator The numerator of the fraction.
+             * @param exponent The power of two of the denominator.
+             * @throw invalid_argument if the exponent is negative or larger than MAX_EXPONENT.
+            */
+            DyadicFraction(long long numerator = 0, int exponent = 0);
+
+            /*
+             * @brief Converts a fraction with a power of two denominator.
+             * @param fraction The fraction to convert.
+             * @throw invalid_argument if the denominator isn't a power of two.
+            */
+            explicit DyadicFraction(const Fraction& fraction);
+
+            /*
+             * @brief Converts a finite double exactly (every finite double is a dyadic fraction).
+             * @param value The double to convert.
+             * @return DyadicFraction The exact value of the double.
+             * @throw invalid_argument if the value isn't finite.
+             * @throw overflow_error if the value needs more than MAX_EXPONENT fraction bits or doesn't fit in the numerator.
+            */
+            static DyadicFraction from_double(double value);
+
+            /*
+             * @brief Returns the numerator of the fraction.
+             * @return long long The numerator of the fraction.
+            */
+            long long numerator() const { return _numerator; }
+
+            /*
+             * @brief Returns the power of two of the denominator.
+             * @return int The exponent of the denominator.
+            */
+            int exponent() const { return _exponent; }
+
+            /*
+             * @brief Converts the fraction to a Fraction.
+             * @return Fraction The fraction.
+             * @throw overflow_error if the numerator or the denominator doesn't fit in an int.
+            */
+            operator Fraction() const;
+
+            /*
+             * @brief Converts the fraction to the nearest double.
+             * @return double The value of the fraction.
+            */
+            double to_double() const;
+
+            /*
+             * @brief Arithmetic operators.
+             * @throw overflow_error if the result doesn't fit.
+            */
+            friend DyadicFraction operator+(const DyadicFraction& a, const DyadicFraction& b);
+            friend DyadicFraction operator-(const DyadicFraction& a, const DyadicFraction& b);
+            friend DyadicFraction operator*(const DyadicFraction& a, const DyadicFraction& b);
+            DyadicFraction operator-() const;
+
+            DyadicFraction& operator+=(const DyadicFraction& other) { return *this = *this + other; }
+            DyadicFraction& operator-=(const DyadicFraction& other) { return *this = *this - other; }
+            DyadicFraction& operator*=(const DyadicFraction& other) { return *this = *this * other; }
+
+            /*
+             * @brief Comparison operators (exact, never overflow).
+            */
+            friend bool operator==(const DyadicFraction& a, const DyadicFraction& b) noexcept;
+            friend bool operator!=(const DyadicFraction& a, const DyadicFraction& b) noexcept;
+            friend bool operator<(const DyadicFraction& a, const DyadicFraction& b) noexcept;
+            friend bool operator>(const DyadicFraction& a, const DyadicFraction& b) noexcept;
+            friend bool operator<=(const DyadicFraction& a, const DyadicFraction& b) noexcept;
+            friend bool operator>=(const DyadicFraction& a, const DyadicFraction& b) noexcept;
+
+            /*
+             * @brief Prints the fraction as numerator/denominator.
+            */
+            friend std::ostream& operator<<(std::ostream& os, const DyadicFraction& fraction);
+    };
+}
+
+#endif
@@ -0,0 +1,204 @@
+/*
+ *  Software Systems CPP Course Assignment 3
+ *  Copyright (C) 2023  Roy Simanovich
+ * 
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ * 
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <https://www.gnu.org/licenses/>.
+*/
+
+#ifndef _FIXEDFRACTION_HPP
+#define _FIXEDFRACTION_HPP
+
+#include <iostream>
+#include <stdexcept>
+#include "Fraction.hpp"
+#include "Overflow.hpp"
+
+namespace ariel
+{
+    /*
+     * @brief A fraction with a denominator fixed at compile time, e.g. FixedFraction<48000> for audio samples.
+     * @note Only the numerator is stored, so addition and subtraction are plain (overflow checked) integer operations.
+     * @note Multiplication and division round to the nearest multiple of 1/D (ties away from zero), like fixed point.
+     * @note Conversions to and from Fraction are exact; converting a value that isn't a multiple of 1/D throws.
+    */
+    template <int D> requires (D > 0)
+    class FixedFraction
+    {
+        private:
+            /*
+             * @brief The numerator of the fraction (the value is _numerator / D).
+            */
+            int _numerator;
+
+            /*
+             * @brief Narrows a wide numerator.
+             * @param numerator The wide numerator.
+             * @return FixedFraction The fraction.
+             * @throw overflow_error if the numerator doesn't fit in an int.
+            */
+            static FixedFraction __narrow(long long numerator) {
+                if (!overflow::fits_int(numerator))
+                {
+                    FRACTION_COUNT(overflows);
+                    FRACTION_COUNT(exceptions);
+                    throw std::overflow_error("Fixed fraction overflow");
+                }
+
+                return from_raw(static_cast<int>(numerator));
+            }
+
+            /*
+             * @brief Divides and rounds to the nearest integer, ties away from zero.
+             * @param numerator The dividend.
+             * @param denominator The divisor (must be positive).
+             * @return long long The rounded quotient.
+            */
+            static long long __divide_rounded(long long numerator, long long denominator) {
+                long long quotient = numerator / denominator;
+                long long remainder = numerator % denominator;
+
+                if (2 * ((remainder < 0) ? -remainder : remainder) >= denominator)
+                    quotient += (numerator < 0) ? -1 : 1;
+
+                return quotient;
+            }
+
+        public:
+            /*
+             * @brief The fixed denominator.
+            */
+            static constexpr int denominator_value = D;
+
+            /*
+             * @brief Default constructor of the FixedFraction class.
+             * @note The default fraction is 0.
+            */
+            constexpr FixedFraction() noexcept: _numerator(0) {}
+
+            /*
+             * @brief Converts an integer.
+             * @param value The integer.
+             * @throw overflow_error if value * D doesn't fit in an int.
+            */
+            explicit FixedFraction(int value): FixedFraction(__narrow(static_cast<long long>(value) * D)) {}
+
+            /*
+             * @brief Converts a fraction exactly.
+             * @param fraction The fraction to convert.
+             * @throw invalid_argument if the fraction isn't a multiple of 1/D.
+             * @throw overflow_error if the numerator over D doesn't fit in an int.
+            */
+            explicit FixedFraction(const Fraction& fraction): _numerator(0) {
+                if (D % fraction.denominator() != 0)
+                {
+                    FRACTION_COUNT(exceptions);
+                    throw std::invalid_argument("Fraction isn't a multiple of the fixed denominator");
+                }
+
+                *this = __narrow(static_cast<long long>(fraction.numerator()) * (D / fraction.denominator()));
+            }
+
+            /*
+             * @brief Creates a fraction from its numerator over D.
+             * @param numerator The numerator.
+             * @return FixedFraction The fraction numerator / D.
+            */
+            static constexpr FixedFraction from_raw(int numerator) noexcept {
+                FixedFraction fraction;
+                fraction._numerator = numerator;
+                return fraction;
+            }
+
+            /*
+             * @brief Returns the numerator over D.
+             * @return int The (unreduced) numerator.
+            */
+            constexpr int raw() const noexcept { return _numerator; }
+
+            /*
+             * @brief Converts the fraction to a reduced Fraction.
+             * @return Fraction The reduced fraction.
+            */
+            operator Fraction() const { return Fraction(_numerator, D); }
+
+            FixedFraction operator+(const FixedFraction& other) const {
+                int sum;
+
+                if (overflow::add(_numerator, other._numerator, sum))
+                    return __narrow(static_cast<long long>(_numerator) + other._numerator);     // Throws.
+
+                return from_raw(sum);
+            }
+
+            FixedFraction operator-(const FixedFraction& other) const {
+                int difference;
+
+                if (overflow::sub(_numerator, other._numerator, difference))
+                    return __narrow(static_cast<long long>(_numerator) - other._numerator);     // Throws.
+
+                return from_raw(difference);
+            }
+
+            /*
+             * @note (a / D) * (b / D) = (a * b / D) / D, a single division by a compile-time constant.
+            */
+            FixedFraction operator*(const FixedFraction& other) const {
+                return __narrow(__divide_rounded(static_cast<long long>(_numerator) * other._numerator, D));
+            }
+
+            /*
+             * @throw invalid_argument if other is 0.
+            */
+            FixedFraction operator/(const FixedFraction& other) const {
+                if (other._numerator == 0)
+                {
+                    FRACTION_COUNT(exceptions);
+                    throw std::invalid_argument("Can't divide by zero");
+                }
+
+                long long numerator = static_cast<long long>(_numerator) * D;
+                long long denominator = other._numerator;
+
+                if (denominator < 0)
+                {
+                    numerator = -numerator;
+                    denominator = -denominator;
+                }
+
+                return __narrow(__divide_rounded(numerator, denominator));
+            }
+
+            FixedFraction operator-() const { return __narrow(-static_cast<long long>(_numerator)); }
+
+            FixedFraction& operator+=(const FixedFraction& other) { return *this = *this + other; }
+            FixedFraction& operator-=(const FixedFraction& other) { return *this = *this - other; }
+            FixedFraction& operator*=(const FixedFraction& other) { return *this = *this * other; }
+            FixedFraction& operator/=(const FixedFraction& other) { return *this = *this / other; }
+
+            constexpr bool operator==(const FixedFraction& other) const noexcept { return _numerator == other._numerator; }
+            constexpr bool operator!=(const FixedFraction& other) const noexcept { return _numerator != other._numerator; }
+            constexpr bool operator<(const FixedFraction& other) const noexcept { return _numerator < other._numerator; }
+            constexpr bool operator>(const FixedFraction& other) const noexcept { return _numerator > other._numerator; }
+            constexpr bool operator<=(const FixedFraction& other) const noexcept { return _numerator <= other._numerator; }
+            constexpr bool operator>=(const FixedFraction& other) const noexcept { return _numerator >= other._numerator; }
+
+            /*
+             * @brief Prints the reduced fraction (numerator/denominator).
+            */
+            friend std::ostream& operator<<(std::ostream& os, const FixedFraction& fraction) {
+                return os << Fraction(fraction);
+            }
+    };
+}
+
+#endif
@@ -15,18 +15,32 @@
  *  along with this program.  If not, see <https://www.gnu.org/licenses/>.
 */
 
+#include <bit>
+#include <cmath>
+#include <limits>
+#include <numeric>
 #include "Fraction.hpp"
+#include "FractionMetrics.hpp"
+#include "Overflow.hpp"
 
 using namespace std;
 
 namespace ariel
 {
-    Fraction::Fraction(): _numerator(0), _denominator(1) {}
+    Fraction::Fraction() noexcept: _numerator(0), _denominator(1) {
+        FRACTION_COUNT(constructions);
+    }
+
+    Fraction::Fraction(float number) noexcept {
+        FRACTION_LATENCY(construct);
+        FRACTION_COUNT(constructions);
+        FRACTION_COUNT(float_conversions);
+        FRACTION_PROBE(float__entry);
 
-    Fraction::Fraction(float number) {
         int power = 1;
         while (number != (int)number && power < 1000)
         {
+            FRACTION_COUNT(float_iterations);
             number *= 10;
             power *= 10;
         }
@@ -35,26 +49,42 @@ namespace ariel
         _denominator = power;
 
         __reduce();
+
+        FRACTION_PROBE2(float__return, _numerator, _denominator);
     }
 
     Fraction::Fraction(int numerator, int denominator): _numerator(numerator), _denominator(denominator) {
+        FRACTION_LATENCY(construct);
+        FRACTION_COUNT(constructions);
+
         if (denominator == 0)
+        {
+            FRACTION_COUNT(exceptions);
             throw std::invalid_argument("Denominator can't be zero");
+        }
 
-        if (denominator < 0)
+        // Reduce first, so INT_MIN is only negated when it is still there after the reduction.
+        __reduce();
+
+        if (_denominator < 0)
         {
+            if (_numerator == numeric_limits<int>::min() || _denominator == numeric_limits<int>::min())
+            {
+                FRACTION_COUNT(overflows);
+                FRACTION_COUNT(exceptions);
+                throw overflow_error("Fraction doesn't fit with a positive denominator");
+            }
+
             _numerator *= -1;
             _denominator *= -1;
         }
-
-        __reduce();
     }
 
-    Fraction::Fraction(const Fraction& other): _numerator(other._numerator), _denominator(other._denominator) {}
+    Fraction::Fraction(const Fraction& other) noexcept: _numerator(other._numerator), _denominator(other._denominator) {}
 
     Fraction::Fraction(Fraction&& other) noexcept: _numerator(other._numerator), _denominator(other._denominator) {}
 
-    Fraction& Fraction::operator=(const Fraction& other) {
+    Fraction& Fraction::operator=(const Fraction& other) noexcept {
         if (this == &other)
             return *this;
         
@@ -76,114 +106,117 @@ namespace ariel
     // Stream operators (IO friend functions)
 
     ostream& operator<<(ostream& os, const Fraction& fraction) {
+        FRACTION_LATENCY(format);
+        FRACTION_PROBE2(format__entry, fraction._numerator, fraction._denominator);
         os << fraction._numerator << "/" << fraction._denominator;
+        FRACTION_PROBE(format__return);
         return os;
     }
 
     istream& operator>>(istream& is, Fraction& fraction) {
+        FRACTION_LATENCY(parse);
+        FRACTION_PROBE(parse__entry);
         int numerator, denominator;
         char slash;
 
         is >> numerator >> slash >> denominator;
 
         if (slash != '/')
+        {
+            FRACTION_COUNT(exceptions);
             throw invalid_argument("Invalid input");
+        }
 
         fraction = Fraction(numerator, denominator);
 
+        FRACTION_PROBE2(parse__return, fraction._numerator, fraction._denominator);
         return is;
     }
 
 
     // Operators with fractions
 
-    const Fraction Fraction::operator+(const Fraction& other) const {
-        int numerator = (_numerator * other._denominator) + (other._numerator * _denominator);
-        int denominator = (_denominator * other._denominator);
-
-        __reduce(numerator, denominator);
+    Fraction Fraction::__wide(long long numerator, long long denominator) {
+        FRACTION_COUNT(reductions);
 
-        return Fraction(numerator, denominator);
-    }
+        if (denominator < 0)
+        {
+            numerator = -numerator;
+            denominator = -denominator;
+        }
 
-    const Fraction Fraction::operator-(const Fraction& other) const {
-        int numerator = (_numerator * other._denominator) - (other._numerator * _denominator);
-        int denominator = (_denominator * other._denominator);
+        long long divisor = gcd(numerator, denominator);
+        numerator /= divisor;
+        denominator /= divisor;
 
-        __reduce(numerator, denominator);
+        if (!overflow::fits_int(numerator) || !overflow::fits_int(denominator))
+        {
+            FRACTION_COUNT(overflows);
+            FRACTION_COUNT(exceptions);
+            throw overflow_error("Result doesn't fit in a fraction");
+        }
 
-        return Fraction(numerator, denominator);
+        return __unchecked(static_cast<int>(numerator), static_cast<int>(denominator));
     }
 
-    const Fraction Fraction::operator*(const Fraction& other) const {
-        int numerator = (_numerator * other._numerator);
-        int denominator = (_denominator * other._denominator);
+    const Fraction Fraction::operator+(const Fraction& other) const {
+        FRACTION_LATENCY(add);
+        return __wide((static_cast<long long>(_numerator) * other._denominator) + (static_cast<long long>(other._numerator) * _denominator),
+                      static_cast<long long>(_denominator) * other._denominator);
+    }
 
-        __reduce(numerator, denominator);
+    const Fraction Fraction::operator-(const Fraction& other) const {
+        FRACTION_LATENCY(add);
+        return __wide((static_cast<long long>(_numerator) * other._denominator) - (static_cast<long long>(other._numerator) * _denominator),
+                      static_cast<long long>(_denominator) * other._denominator);
+    }
 
-        return Fraction(numerator, denominator);
+    const Fraction Fraction::operator*(const Fraction& other) const {
+        FRACTION_LATENCY(mul);
+        return __wide(static_cast<long long>(_numerator) * other._numerator, static_cast<long long>(_denominator) * other._denominator);
     }
 
     const Fraction Fraction::operator/(const Fraction& other) const {
+        FRACTION_LATENCY(div);
         if (other._numerator == 0)
+        {
+            FRACTION_COUNT(exceptions);
             throw invalid_argument("Can't divide by zero");
+        }
 
-        int numerator = (_numerator * other._denominator);
-        int denominator = (_denominator * other._numerator);
-
-        __reduce(numerator, denominator);
-
-        return Fraction(numerator, denominator);
+        return __wide(static_cast<long long>(_numerator) * other._denominator, static_cast<long long>(_denominator) * other._numerator);
     }
 
-    const Fraction Fraction::operator+() const {
-        return Fraction(_numerator, _denominator);
+    const Fraction Fraction::operator+() const noexcept {
+        return __unchecked(_numerator, _denominator);
     }
 
-    const Fraction Fraction::operator-() const {
-        return Fraction(-_numerator, _denominator);
+    const Fraction Fraction::operator-() const noexcept {
+        return __unchecked(-_numerator, _denominator);
     }
 
     Fraction& operator+=(Fraction& fraction, const Fraction& other) {
-        fraction._numerator = (fraction._numerator * other._denominator) + (other._numerator * fraction._denominator);
-        fraction._denominator *= other._denominator;
-
-        fraction.__reduce();
-
+        fraction = fraction + other;
         return fraction;
     }
 
     Fraction& operator-=(Fraction& fraction, const Fraction& other) {
-        fraction._numerator = (fraction._numerator * other._denominator) - (other._numerator * fraction._denominator);
-        fraction._denominator *= other._denominator;
-
-        fraction.__reduce();
-
+        fraction = fraction - other;
         return fraction;
     }
 
     Fraction& operator*=(Fraction& fraction, const Fraction& other) {
-        fraction._numerator *= other._numerator;
-        fraction._denominator *= other._denominator;
-
-        fraction.__reduce();
-
+        fraction = fraction * other;
         return fraction;
     }
 
     Fraction& operator/=(Fraction& fraction, const Fraction& other) {
-        if (other._numerator == 0)
-            throw invalid_argument("Can't divide by zero");
-
-        fraction._numerator *= other._denominator;
-        fraction._denominator *= other._numerator;
-
-        fraction.__reduce();
-
+        fraction = fraction / other;
         return fraction;
     }
 
-    Fraction& Fraction::operator++() {
+    Fraction& Fraction::operator++() noexcept {
+        FRACTION_LATENCY(add);
         _numerator += _denominator;
 
         __reduce();
@@ -191,13 +224,14 @@ namespace ariel
         return *this;
     }
 
-    Fraction Fraction::operator++(int) {
+    Fraction Fraction::operator++(int) noexcept {
         Fraction temp = *this;
         ++(*this);
         return temp;
     }
 
-    Fraction& Fraction::operator--() {
+    Fraction& Fraction::operator--() noexcept {
+        FRACTION_LATENCY(add);
         _numerator -= _denominator;
 
         __reduce();
@@ -205,33 +239,39 @@ namespace ariel
         return *this;
     }
 
-    Fraction Fraction::operator--(int) {
+    Fraction Fraction::operator--(int) noexcept {
         Fraction temp = *this;
         --(*this);
         return temp;
     }
 
-    bool Fraction::operator==(const Fraction& other) const {
+    bool Fraction::operator==(const Fraction& other) const noexcept {
+        FRACTION_LATENCY(compare);
         return (_numerator == other._numerator && _denominator == other._denominator);
     }
 
-    bool Fraction::operator!=(const Fraction& other) const {
+    bool Fraction::operator!=(const Fraction& other) const noexcept {
+        FRACTION_LATENCY(compare);
         return !(*this == other);
     }
 
-    bool Fraction::operator<(const Fraction& other) const {
+    bool Fraction::operator<(const Fraction& other) const noexcept {
+        FRACTION_LATENCY(compare);
         return (_numerator * other._denominator) < (other._numerator * _denominator);
     }
 
-    bool Fraction::operator>(const Fraction& other) const {
+    bool Fraction::operator>(const Fraction& other) const noexcept {
+        FRACTION_LATENCY(compare);
         return (_numerator * other._denominator) > (other._numerator * _denominator);
     }
 
-    bool Fraction::operator<=(const Fraction& other) const {
+    bool Fraction::operator<=(const Fraction& other) const noexcept {
+        FRACTION_LATENCY(compare);
         return !(*this > other);
     }
 
-    bool Fraction::operator>=(const Fraction& other) const {
+    bool Fraction::operator>=(const Fraction& other) const noexcept {
+        FRACTION_LATENCY(compare);
         return !(*this < other);
     }
 
@@ -239,44 +279,59 @@ namespace ariel
     // Operators with floats
 
     const Fraction Fraction::operator+(const float& number) const {
+        FRACTION_LATENCY(add);
         return *this + Fraction(number);
     }
     
     const Fraction operator+(const float& num, const Fraction& other) {
+        FRACTION_LATENCY(add);
         return Fraction(num) + other;
     }
 
     const Fraction Fraction::operator-(const float& number) const {
+        FRACTION_LATENCY(add);
         return *this - Fraction(number);
     }
 
     const Fraction operator-(const float& num, const Fraction& other) {
+        FRACTION_LATENCY(add);
         return Fraction(num) - other;
     }
 
     const Fraction Fraction::operator*(const float& number) const {
+        FRACTION_LATENCY(mul);
         return *this * Fraction(number);
     }
 
     const Fraction operator*(const float& num, const Fraction& other) {
+        FRACTION_LATENCY(mul);
         return Fraction(num) * other;
     }
 
     const Fraction Fraction::operator/(const float& number) const {
+        FRACTION_LATENCY(div);
         if (number == 0)
+        {
+            FRACTION_COUNT(exceptions);
             throw invalid_argument("Can't divide by zero");
+        }
 
         return *this / Fraction(number);
     }
 
     const Fraction operator/(const float& num, const Fraction& other) {
+        FRACTION_LATENCY(div);
         if (other._numerator == 0)
+        {
+            FRACTION_COUNT(exceptions);
             throw invalid_argument("Can't divide by zero");
+        }
 
         return Fraction(num) / other;
     }
 
     Fraction& operator+=(Fraction& fraction, const float& number) {
+        FRACTION_LATENCY(add);
         Fraction temp = fraction + Fraction(number);
         
         fraction._numerator = temp._numerator;
@@ -288,6 +343,7 @@ namespace ariel
     }
 
     Fraction& operator-=(Fraction& fraction, const float& number) {
+        FRACTION_LATENCY(add);
         Fraction temp = fraction - Fraction(number);
         
         fraction._numerator = temp._numerator;
@@ -299,6 +355,7 @@ namespace ariel
     }
 
     Fraction& operator*=(Fraction& fraction, const float& number) {
+        FRACTION_LATENCY(mul);
         Fraction temp = fraction * Fraction(number);
         
         fraction._numerator = temp._numerator;
@@ -310,8 +367,12 @@ namespace ariel
     }
 
     Fraction& operator/=(Fraction& fraction, const float& number) {
+        FRACTION_LATENCY(div);
         if (number == 0)
+        {
+            FRACTION_COUNT(exceptions);
             throw invalid_argument("Can't divide by zero");
+        }
             
         Fraction temp = fraction / Fraction(number);
         
@@ -323,51 +384,230 @@ namespace ariel
         return fraction;
     }
 
-    bool Fraction::operator==(const float& number) const {
+    bool Fraction::operator==(const float& number) const noexcept {
+        FRACTION_LATENCY(compare);
         return *this == Fraction(number);
     }
 
-    bool operator==(const float& num, const Fraction& other) {
+    bool operator==(const float& num, const Fraction& other) noexcept {
+        FRACTION_LATENCY(compare);
         return Fraction(num) == other;
     }
 
-    bool Fraction::operator!=(const float& number) const {
+    bool Fraction::operator!=(const float& number) const noexcept {
+        FRACTION_LATENCY(compare);
         return !(*this == Fraction(number));
     }
 
-    bool operator!=(const float& num, const Fraction& other) {
+    bool operator!=(const float& num, const Fraction& other) noexcept {
+        FRACTION_LATENCY(compare);
         return !(Fraction(num) == other);
     }
 
-    bool Fraction::operator<(const float& number) const {
+    bool Fraction::operator<(const float& number) const noexcept {
+        FRACTION_LATENCY(compare);
         return *this < Fraction(number);
     }
 
-    bool operator<(const float& num, const Fraction& other) {
+    bool operator<(const float& num, const Fraction& other) noexcept {
+        FRACTION_LATENCY(compare);
         return Fraction(num) < other;
     }
 
-    bool Fraction::operator>(const float& number) const {
+    bool Fraction::operator>(const float& number) const noexcept {
+        FRACTION_LATENCY(compare);
         return *this > Fraction(number);
     }
 
-    bool operator>(const float& num, const Fraction& other) {
+    bool operator>(const float& num, const Fraction& other) noexcept {
+        FRACTION_LATENCY(compare);
         return Fraction(num) > other;
     }
 
-    bool Fraction::operator<=(const float& number) const {
+    bool Fraction::operator<=(const float& number) const noexcept {
+        FRACTION_LATENCY(compare);
         return !(*this > Fraction(number));
     }
 
-    bool operator<=(const float& num, const Fraction& other) {
+    bool operator<=(const float& num, const Fraction& other) noexcept {
+        FRACTION_LATENCY(compare);
         return !(Fraction(num) > other);
     }
 
-    bool Fraction::operator>=(const float& number) const {
+    bool Fraction::operator>=(const float& number) const noexcept {
+        FRACTION_LATENCY(compare);
         return !(*this < Fraction(number));
     }
 
-    bool operator>=(const float& num, const Fraction& other) {
+    bool operator>=(const float& num, const Fraction& other) noexcept {
+        FRACTION_LATENCY(compare);
         return !(Fraction(num) < other);
     }
-}
\ No newline at end of file
+
+
+    // Conversions
+
+    double Fraction::to_double() const noexcept {
+        return static_cast<double>(_numerator) / _denominator;
+    }
+
+    float Fraction::to_float() const noexcept {
+        if (_numerator == 0)
+            return 0.0f;
+
+        unsigned long long numerator = (_numerator < 0) ? 0 - static_cast<unsigned long long>(_numerator) : static_cast<unsigned long long>(_numerator);
+        unsigned long long denominator = static_cast<unsigned long long>(_denominator);
+
+        // Scale so the quotient has 25 bits: 24 for the significand and one rounding bit.
+        // The first guess is at most one bit short; the members are below 2^31, so the scaled values always fit in 64 bits.
+        int shift = 24 - static_cast<int>(bit_width(numerator)) + static_cast<int>(bit_width(denominator));
+        unsigned long long quotient, remainder;
+
+        while (true)
+        {
+            unsigned long long scaled_numerator = (shift >= 0) ? numerator << shift : numerator;
+            unsigned long long scaled_denominator = (shift >= 0) ? denominator : denominator << -shift;
+
+            quotient = scaled_numerator / scaled_denominator;
+            remainder = scaled_numerator % scaled_denominator;
+
+            if (quotient >= (1ull << 24))
+                break;
+
+            shift++;
+        }
+
+        // Round half to even, with the remainder as the sticky bit.
+        unsigned long long significand = quotient >> 1;
+
+        if ((quotient & 1) != 0 && (remainder != 0 || (significand & 1) != 0))
+            significand++;
+
+        float magnitude = ldexp(static_cast<float>(significand), 1 - shift);
+        return (_numerator < 0) ? -magnitude : magnitude;
+    }
+
+    /*
+     * @brief Returns the simplest fraction in a closed interval of positive values.
+     * @param lo_numerator The numerator of the lower bound (positive).
+     * @param lo_denominator The denominator of the lower bound (positive).
+     * @param hi_numerator The numerator of the upper bound (positive).
+     * @param hi_denominator The denominator of the upper bound (positive).
+     * @return Fraction The fraction with the smallest denominator in the interval.
+     * @note Both bounds are in the interval, so the result's members are at most theirs and always fit.
+    */
+    static Fraction __simplest(long long lo_numerator, long long lo_denominator, long long hi_numerator, long long hi_denominator) {
+        // The last two convergents, p/q = term * p1/q1 + p0/q0.
+        long long p0 = 0, q0 = 1, p1 = 1, q1 = 0;
+        long long term;
+
+        while (true)
+        {
+            term = lo_numerator / lo_denominator;
+
+            // An integral lower bound, or an integer above it that is still in the interval, ends the expansion.
+            if (lo_numerator % lo_denominator == 0)
+                break;
+
+            if ((term + 1) * hi_denominator <= hi_numerator)
+            {
+                term++;
+                break;
+            }
+
+            // Both bounds share the term: take it and continue on the reciprocals of the remainders, which swaps the bounds.
+            long long p = term * p1 + p0, q = term * q1 + q0;
+            p0 = p1;
+            q0 = q1;
+            p1 = p;
+            q1 = q;
+
+            long long lo_remainder = lo_numerator - term * lo_denominator;
+            long long hi_remainder = hi_numerator - term * hi_denominator;
+
+            hi_numerator = lo_denominator;
+            lo_numerator = hi_denominator;
+            lo_denominator = hi_remainder;
+            hi_denominator = lo_remainder;
+        }
+
+        return Fraction(static_cast<int>(term * p1 + p0), static_cast<int>(term * q1 + q0));
+    }
+
+    Fraction Fraction::simplest_between(const Fraction& lo, const Fraction& hi) {
+        // Widened, the int cross products of operator< can overflow here.
+        if (static_cast<long long>(hi._numerator) * lo._denominator < static_cast<long long>(lo._numerator) * hi._denominator)
+        {
+            FRACTION_COUNT(exceptions);
+            throw invalid_argument("Lower bound can't be greater than the upper bound");
+        }
+
+        if (lo._numerator <= 0 && hi._numerator >= 0)
+            return Fraction();
+
+        // A negative interval is the mirror of a positive one.
+        if (hi._numerator < 0)
+            return -__simplest(-static_cast<long long>(hi._numerator), hi._denominator, -static_cast<long long>(lo._numerator), lo._denominator);
+
+        return __simplest(lo._numerator, lo._denominator, hi._numerator, hi._denominator);
+    }
+
+
+    // Exception-free API
+
+    /*
+     * @brief Reduces a wide fraction and wraps it in a FractionResult.
+     * @param numerator The numerator of the fraction.
+     * @param denominator The denominator of the fraction (can't be 0).
+     * @return FractionResult The reduced fraction, or FractionError::Overflow if it doesn't fit in a fraction.
+    */
+    static FractionResult __result(long long numerator, long long denominator) noexcept {
+        if (denominator < 0)
+        {
+            numerator = -numerator;
+            denominator = -denominator;
+        }
+
+        long long g = gcd(numerator, denominator);
+        numerator /= g;
+        denominator /= g;
+
+        if (!overflow::fits_int(numerator) || !overflow::fits_int(denominator))
+        {
+            FRACTION_COUNT(overflows);
+            return {Fraction(), FractionError::Overflow};
+        }
+
+        // The denominator is positive here, so the constructor can't throw.
+        return {Fraction(static_cast<int>(numerator), static_cast<int>(denominator)), FractionError::None};
+    }
+
+    FractionResult Fraction::make(int numerator, int denominator) noexcept {
+        if (denominator == 0)
+            return {Fraction(), FractionError::ZeroDenominator};
+
+        // The wide path also covers negating INT_MIN, which overflows an int.
+        return __result(numerator, denominator);
+    }
+
+    FractionResult checked_add(const Fraction& a, const Fraction& b) noexcept {
+        return __result((static_cast<long long>(a.numerator()) * b.denominator()) + (static_cast<long long>(b.numerator()) * a.denominator()),
+                        static_cast<long long>(a.denominator()) * b.denominator());
+    }
+
+    FractionResult checked_sub(const Fraction& a, const Fraction& b) noexcept {
+        return __result((static_cast<long long>(a.numerator()) * b.denominator()) - (static_cast<long long>(b.numerator()) * a.denominator()),
+                        static_cast<long long>(a.denominator()) * b.denominator());
+    }
+
+    FractionResult checked_mul(const Fraction& a, const Fraction& b) noexcept {
+        return __result(static_cast<long long>(a.numerator()) * b.numerator(), static_cast<long long>(a.denominator()) * b.denominator());
+    }
+
+    FractionResult checked_div(const Fraction& a, const Fraction& b) noexcept {
+        if (b.numerator() == 0)
+            return {Fraction(), FractionError::DivisionByZero};
+
+        return __result(static_cast<long long>(a.numerator()) * b.denominator(), static_cast<long long>(a.denominator()) * b.numerator());
+    }
+}
@@ -15,14 +15,34 @@
  *  along with this program.  If not, see <https://www.gnu.org/licenses/>.
 */
 
+#ifndef _FRACTION_HPP
+#define _FRACTION_HPP
+
 #include <iostream>
 #include <stdexcept>
 #include <string>
 #include <sstream>
 #include <fstream>
+#include "FractionProbes.hpp"
+#include "FractionStats.hpp"
 
 namespace ariel
 {
+    /*
+     * @brief Error codes of the exception-free API of the Fraction class.
+    */
+    enum class FractionError
+    {
+        None,               // No error.
+        ZeroDenominator,    // The denominator is 0.
+        DivisionByZero,     // The divisor is 0.
+        Overflow            // The result doesn't fit in a fraction.
+    };
+
+    struct FractionResult;
+    class SmallFraction;
+    class AtomicFraction;
+
     class Fraction
     {
         private:
@@ -43,10 +63,11 @@ namespace ariel
              * @brief Reduces the fraction to its simplest form.
              * @note This function is private because it is only used internally.
             */
-            void __reduce() {
-                int gcd = __gcd(abs(_numerator), abs(_denominator));
-                _numerator /= gcd;
-                _denominator /= gcd;
+            void __reduce() noexcept {
+                FRACTION_COUNT(reductions);
+                FRACTION_PROBE2(reduce__entry, _numerator, _denominator);
+                __reduce_members(_numerator, _denominator);
+                FRACTION_PROBE2(reduce__return, _numerator, _denominator);
             }
 
             /*
@@ -56,24 +77,91 @@ namespace ariel
              * @note This function is private because it is only used internally.
              * @note This function is static because it is only used internally and doesn't require an instance of the class.
             */
-            static void __reduce(int& numerator, int& denominator) {
-                int gcd = __gcd(abs(numerator), abs(denominator));
-                numerator /= gcd;
-                denominator /= gcd;
+            static void __reduce(int& numerator, int& denominator) noexcept {
+                FRACTION_COUNT(reductions);
+                FRACTION_PROBE2(reduce__entry, numerator, denominator);
+                __reduce_members(numerator, denominator);
+                FRACTION_PROBE2(reduce__return, numerator, denominator);
+            }
+
+            /*
+             * @brief Divides a numerator and a denominator by their greatest common divisor.
+             * @param numerator The numerator of the fraction.
+             * @param denominator The denominator of the fraction.
+             * @note The magnitudes are taken as unsigned and the division is done in 64 bits, so INT_MIN is reduced safely.
+            */
+            static void __reduce_members(int& numerator, int& denominator) noexcept {
+                long long gcd = __gcd(__magnitude(numerator), __magnitude(denominator));
+                numerator = static_cast<int>(numerator / gcd);
+                denominator = static_cast<int>(denominator / gcd);
+            }
+
+            /*
+             * @brief Returns the absolute value of a number as unsigned, which holds the magnitude of INT_MIN too.
+             * @param number The number.
+             * @return unsigned int The absolute value of the number.
+            */
+            static unsigned int __magnitude(int number) noexcept {
+                return (number < 0) ? 0u - static_cast<unsigned int>(number) : static_cast<unsigned int>(number);
             }
 
             /*
              * @brief Calculates the greatest common divisor of two numbers.
              * @param a The first number.
              * @param b The second number.
-             * @return int The greatest common divisor of the two numbers.
+             * @return unsigned int The greatest common divisor of the two numbers.
              * @note This function is used to reduce the fraction to its simplest form.
              * @note This function is static because it is only used internally and doesn't require an instance of the class.
             */
-            static int __gcd(int a, int b) {
+            static unsigned int __gcd(unsigned int a, unsigned int b) noexcept {
+                FRACTION_COUNT(gcd_iterations);
                 return (b == 0) ? a:__gcd(b, a % b);
             }
 
+            /*
+             * @brief Creates a fraction without checking or normalizing it.
+             * @param numerator The numerator of the fraction.
+             * @param denominator The denominator of the fraction (must be positive).
+             * @return Fraction The fraction.
+             * @note The fraction must already be reduced; used by the operators that can't fail, so they can be noexcept.
+            */
+            static Fraction __unchecked(int numerator, int denominator) noexcept {
+                Fraction fraction;
+                fraction._numerator = numerator;
+                fraction._denominator = denominator;
+                return fraction;
+            }
+
+            /*
+             * @brief Reduces a wide result of an operator to a fraction.
+             * @param numerator The numerator of the result.
+             * @param denominator The denominator of the result (can't be 0).
+             * @return Fraction The reduced fraction, with a positive denominator.
+             * @throw overflow_error if the reduced fraction doesn't fit in a Fraction.
+             * @note The products of two int members always fit in a long long, so the operators can't wrap before this check.
+            */
+            static Fraction __wide(long long numerator, long long denominator);
+
+            /*
+             * @brief The narrow storage types widen through __unchecked, since their values are already reduced.
+            */
+            friend class SmallFraction;
+
+            /*
+             * @brief The atomic fraction unpacks its canonical bits through __unchecked.
+            */
+            friend class AtomicFraction;
+
+            /*
+             * @brief The fractional part of a reduced fraction is already reduced.
+            */
+            friend Fraction frac(const Fraction& fraction) noexcept;
+
+            /*
+             * @brief The powers of a reduced fraction are already reduced.
+            */
+            friend Fraction pow(const Fraction& base, int exponent);
+
         public:
             /*********************/
             /* Constructors zone */
@@ -83,29 +171,39 @@ namespace ariel
              * @brief Default constructor of the Fraction class.
              * @note The default fraction is 0/1 (zero).
             */
-            Fraction();
+            Fraction() noexcept;
 
             /*
              * @brief Convert constructor from float to Fraction.
              * @param number The number to convert to a fraction.
              * @note This constructor is used to convert a float to a fraction.
             */
-            Fraction(float number);
+            Fraction(float number) noexcept;
 
             /*
              * @brief Construct a new Fraction object
              * @param numerator The numerator of the fraction.
              * @param denominator The denominator of the fraction.
              * @throw invalid_argument if the denominator is 0.
+             * @throw overflow_error if the reduced fraction can't have a positive denominator (e.g. 1/INT_MIN).
              * @note The fraction will be reduced to its simplest form.
             */
             Fraction(int numerator, int denominator);
 
+            /*
+             * @brief Creates a fraction without throwing.
+             * @param numerator The numerator of the fraction.
+             * @param denominator The denominator of the fraction.
+             * @return FractionResult The reduced fraction, or FractionError::ZeroDenominator if the denominator is 0.
+             * @note This is the exception-free version of Fraction(int, int), for hot paths.
+            */
+            static FractionResult make(int numerator, int denominator) noexcept;
+
             /*
              * @brief Copy constructor of the Fraction class.
              * @param other The fraction to copy.
             */
-            Fraction(const Fraction& other);
+            Fraction(const Fraction& other) noexcept;
 
             /*
              * @brief Move constructor of the Fraction class.
@@ -121,6 +219,52 @@ namespace ariel
             ~Fraction() = default;
 
 
+            /****************/
+            /* Getters zone */
+            /****************/
+
+            /*
+             * @brief Returns the numerator of the fraction.
+             * @return int The numerator of the fraction (carries the sign).
+            */
+            int numerator() const { return _numerator; }
+
+            /*
+             * @brief Returns the denominator of the fraction.
+             * @return int The denominator of the fraction (always positive).
+            */
+            int denominator() const { return _denominator; }
+
+
+            /********************/
+            /* Conversions zone */
+            /********************/
+
+            /*
+             * @brief Converts the fraction to the nearest double.
+             * @return double The correctly rounded value of the fraction.
+             * @note Both members are exact doubles, so a single IEEE division rounds correctly.
+            */
+            double to_double() const noexcept;
+
+            /*
+             * @brief Converts the fraction to the nearest float (ties to even).
+             * @return float The correctly rounded value of the fraction.
+             * @note Rounding the double quotient again would double-round, so the 24 bit significand is taken from an integer division instead.
+            */
+            float to_float() const noexcept;
+
+            /*
+             * @brief Returns the simplest fraction in a closed interval.
+             * @param lo The lower bound of the interval.
+             * @param hi The upper bound of the interval.
+             * @return Fraction The fraction with the smallest denominator in [lo, hi] (0 if the interval contains it).
+             * @throw invalid_argument if lo is greater than hi.
+             * @note Descends the Stern-Brocot tree a whole run of equal moves at a time (one continued fraction term), so it takes O(log) steps instead of trying every denominator.
+            */
+            static Fraction simplest_between(const Fraction& lo, const Fraction& hi);
+
+
             /**************************************************/
             /* Operators overload zone - Assignment operators */
             /**************************************************/
@@ -130,7 +274,7 @@ namespace ariel
              * @param other The fraction to assign.
              * @return Fraction& The assigned fraction.
             */
-            Fraction& operator=(const Fraction& other);
+            Fraction& operator=(const Fraction& other) noexcept;
 
             /*
              * @brief Assigns a fraction to another fraction.
@@ -170,6 +314,7 @@ namespace ariel
              * @brief Adds two fractions.
              * @param other The fraction to add.
              * @return The result of the addition.
+             * @throw overflow_error if the result doesn't fit in a Fraction.
             */
             const Fraction operator+(const Fraction& other) const;
 
@@ -177,6 +322,7 @@ namespace ariel
              * @brief Adds a fraction to a float.
              * @param num The float to add.
              * @return  The result of the addition.
+             * @throw overflow_error if the result doesn't fit in a Fraction.
             */
             const Fraction operator+(const float& num) const;
 
@@ -185,6 +331,7 @@ namespace ariel
              * @param num The float to add.
              * @param other The fraction to add.
              * @return The result of the addition.
+             * @throw overflow_error if the result doesn't fit in a Fraction.
             */
             friend const Fraction operator+(const float& num, const Fraction& other);
 
@@ -192,6 +339,7 @@ namespace ariel
              * @brief Subtracts two fractions.
              * @param other The fraction to subtract.
              * @return The result of the subtraction.
+             * @throw overflow_error if the result doesn't fit in a Fraction.
             */
             const Fraction operator-(const Fraction& other) const;
 
@@ -199,6 +347,7 @@ namespace ariel
              * @brief Subtracts a fraction from a float.
              * @param num The float to subtract.
              * @return The result of the subtraction.
+             * @throw overflow_error if the result doesn't fit in a Fraction.
             */
             const Fraction operator-(const float& num) const;
 
@@ -207,6 +356,7 @@ namespace ariel
              * @param num The float to subtract.
              * @param other The fraction to subtract.
              * @return The result of the subtraction.
+             * @throw overflow_error if the result doesn't fit in a Fraction.
             */
             friend const Fraction operator-(const float& num, const Fraction& other);
 
@@ -214,6 +364,7 @@ namespace ariel
              * @brief Multiplies two fractions.
              * @param other The fraction to multiply.
              * @return The result of the multiplication.
+             * @throw overflow_error if the result doesn't fit in a Fraction.
             */
             const Fraction operator*(const Fraction& other) const;
 
@@ -221,6 +372,7 @@ namespace ariel
              * @brief Multiplies a fraction by a float.
              * @param num The float to multiply.
              * @return The result of the multiplication.
+             * @throw overflow_error if the result doesn't fit in a Fraction.
             */
             const Fraction operator*(const float& num) const;
 
@@ -229,6 +381,7 @@ namespace ariel
              * @param num The float to multiply.
              * @param other The fraction to multiply.
              * @return The result of the multiplication.
+             * @throw overflow_error if the result doesn't fit in a Fraction.
             */
             friend const Fraction operator*(const float& num, const Fraction& other);
 
@@ -236,6 +389,7 @@ namespace ariel
              * @brief Divides two fractions.
              * @param other The fraction to divide.
              * @return The result of the division.
+             * @throw overflow_error if the result doesn't fit in a Fraction.
             */
             const Fraction operator/(const Fraction& other) const;
 
@@ -258,13 +412,13 @@ namespace ariel
              * @brief Returns the fraction.
              * @return The fraction.
             */
-            const Fraction operator+() const;
+            const Fraction operator+() const noexcept;
 
             /*
              * @brief Negates the fraction.
              * @return The negated fraction.
             */
-            const Fraction operator-() const;
+            const Fraction operator-() const noexcept;
 
             
             /**************************************************/
@@ -276,6 +430,7 @@ namespace ariel
              * @param fraction The current fraction.
              * @param other The fraction to add.
              * @return The current fraction.
+             * @throw overflow_error if the result doesn't fit in a Fraction.
             */
             friend Fraction& operator+=(Fraction& fraction, const Fraction& other);
 
@@ -284,6 +439,7 @@ namespace ariel
              * @param fraction The current fraction.
              * @param num The float to add.
              * @return The current fraction.
+             * @throw overflow_error if the result doesn't fit in a Fraction.
             */
             friend Fraction& operator+=(Fraction& fraction, const float& num);
 
@@ -292,6 +448,7 @@ namespace ariel
              * @param fraction The current fraction.
              * @param other The fraction to subtract.
              * @return The current fraction.
+             * @throw overflow_error if the result doesn't fit in a Fraction.
             */
             friend Fraction& operator-=(Fraction& fraction, const Fraction& other);
 
@@ -300,6 +457,7 @@ namespace ariel
              * @param fraction The current fraction.
              * @param num The float to add.
              * @return The current fraction.
+             * @throw overflow_error if the result doesn't fit in a Fraction.
             */
             friend Fraction& operator-=(Fraction& fraction, const float& num);
 
@@ -308,6 +466,7 @@ namespace ariel
              * @param fraction The current fraction.
              * @param other The fraction to multiply.
              * @return The current fraction.
+             * @throw overflow_error if the result doesn't fit in a Fraction.
             */
             friend Fraction& operator*=(Fraction& fraction, const Fraction& other);
 
@@ -316,6 +475,7 @@ namespace ariel
              * @param fraction The current fraction.
              * @param num The float to multiply.
              * @return The current fraction.
+             * @throw overflow_error if the result doesn't fit in a Fraction.
             */
             friend Fraction& operator*=(Fraction& fraction, const float& num);
 
@@ -324,6 +484,7 @@ namespace ariel
              * @param fraction The current fraction.
              * @param other The fraction to divide.
              * @return The current fraction.
+             * @throw overflow_error if the result doesn't fit in a Fraction.
             */
             friend Fraction& operator/=(Fraction& fraction, const Fraction& other);
 
@@ -339,25 +500,25 @@ namespace ariel
              * @brief Increments the current fraction by 1 (pre-increment).
              * @return The current fraction.
             */
-            Fraction& operator++();
+            Fraction& operator++() noexcept;
 
             /*
              * @brief Decrements the current fraction by 1 (pre-decrement).
              * @return The current fraction.
             */
-            Fraction& operator--();
+            Fraction& operator--() noexcept;
 
             /*
              * @brief Increments the current fraction by 1 (post-increment).
              * @return The current fraction.
             */
-            Fraction operator++(int);
+            Fraction operator++(int) noexcept;
 
             /*
              * @brief Decrements the current fraction by 1 (post-decrement).
              * @return The current fraction.
             */
-            Fraction operator--(int);
+            Fraction operator--(int) noexcept;
 
 
             /**************************************************/
@@ -369,14 +530,14 @@ namespace ariel
              * @param other The fraction to compare.
              * @return True if the fractions are equal, false otherwise.
             */
-            bool operator==(const Fraction& other) const;
+            bool operator==(const Fraction& other) const noexcept;
 
             /*
              * @brief Compares a fraction and an float.
              * @param other The float to compare.
              * @return True if the fractions are equal, false otherwise.
             */
-            bool operator==(const float& other) const;
+            bool operator==(const float& other) const noexcept;
 
             /*
              * @brief Compares a fraction and an float.
@@ -384,21 +545,21 @@ namespace ariel
              * @param num The fraction to compare.
              * @return True if the fractions are equal, false otherwise.
             */
-            friend bool operator==(const float& num, const Fraction& other);
+            friend bool operator==(const float& num, const Fraction& other) noexcept;
 
             /*
              * @brief Compares two fractions.
              * @param other The fraction to compare.
              * @return True if the fractions are not equal, false otherwise.
             */
-            bool operator!=(const Fraction& other) const;
+            bool operator!=(const Fraction& other) const noexcept;
 
             /*
              * @brief Compares a fraction and an float.
              * @param other The float to compare.
              * @return True if the fractions are not equal, false otherwise.
             */
-            bool operator!=(const float& other) const;
+            bool operator!=(const float& other) const noexcept;
 
             /*
              * @brief Compares a fraction and an float.
@@ -406,21 +567,21 @@ namespace ariel
              * @param num The fraction to compare.
              * @return True if the fractions are not equal, false otherwise.
             */
-            friend bool operator!=(const float& num, const Fraction& other);
+            friend bool operator!=(const float& num, const Fraction& other) noexcept;
 
             /*
              * @brief Compares two fractions.
              * @param other The fraction to compare.
              * @return True if the current fraction is greater than the other fraction, false otherwise.
             */
-            bool operator>(const Fraction& other) const;
+            bool operator>(const Fraction& other) const noexcept;
 
             /*
              * @brief Compares a fraction and a float.
              * @param other The float to compare.
              * @return True if the current fraction is greater than the float, false otherwise.
             */
-            bool operator>(const float& other) const;
+            bool operator>(const float& other) const noexcept;
 
             /*
              * @brief Compares a fraction and a float.
@@ -428,21 +589,21 @@ namespace ariel
              * @param num The fraction to compare.
              * @return True if the current fraction is greater than the float, false otherwise.
             */
-            friend bool operator>(const float& num, const Fraction& other);
+            friend bool operator>(const float& num, const Fraction& other) noexcept;
 
             /* 
              * @brief Compares two fractions.
              * @param other The fraction to compare.
              * @return True if the current fraction is less than the other fraction, false otherwise.
             */
-            bool operator<(const Fraction& other) const;
+            bool operator<(const Fraction& other) const noexcept;
 
             /*
              * @brief Compares a fraction and a float.
              * @param other The float to compare.
              * @return True if the current fraction is less than the float, false otherwise.
             */
-            bool operator<(const float& other) const;
+            bool operator<(const float& other) const noexcept;
 
             /*
              * @brief Compares a fraction and a float.
@@ -450,21 +611,21 @@ namespace ariel
              * @param num The fraction to compare.
              * @return True if the current fraction is less than the float, false otherwise.
             */
-            friend bool operator<(const float& num, const Fraction& other);
+            friend bool operator<(const float& num, const Fraction& other) noexcept;
 
             /*
              * @brief Compares two fractions.
              * @param other The fraction to compare.
              * @return True if the current fraction is greater than or equal to the other fraction, false otherwise.
             */
-            bool operator>=(const Fraction& other) const;
+            bool operator>=(const Fraction& other) const noexcept;
 
             /*
              * @brief Compares a fraction and a float.
              * @param other The float to compare.
              * @return True if the current fraction is greater than or equal to the float, false otherwise.
             */
-            bool operator>=(const float& other) const;
+            bool operator>=(const float& other) const noexcept;
 
             /*
              * @brief Compares a fraction and a float.
@@ -472,21 +633,21 @@ namespace ariel
              * @param num The fraction to compare.
              * @return True if the current fraction is greater than or equal to the float, false otherwise.
             */
-            friend bool operator>=(const float& num, const Fraction& other);
+            friend bool operator>=(const float& num, const Fraction& other) noexcept;
 
             /*
              * @brief Compares two fractions.
              * @param other The fraction to compare.
              * @return True if the current fraction is less than or equal to the other fraction, false otherwise.
             */
-            bool operator<=(const Fraction& other) const;
+            bool operator<=(const Fraction& other) const noexcept;
 
             /*
              * @brief Compares a fraction and a float.
              * @param other The float to compare.
              * @return True if the current fraction is less than or equal to the float, false otherwise.
             */
-            bool operator<=(const float& other) const;
+            bool operator<=(const float& other) const noexcept;
 
             /*
              * @brief Compares a fraction and a float.
@@ -494,7 +655,65 @@ namespace ariel
              * @param num The fraction to compare.
              * @return True if the current fraction is less than or equal to the float, false otherwise.
             */
-            friend bool operator<=(const float& num, const Fraction& other);
+            friend bool operator<=(const float& num, const Fraction& other) noexcept;
+    };
+
+    /*
+     * @brief The result of an exception-free Fraction operation, either a fraction or an error code.
+     * @note Modeled after std::expected, which isn't available in C++20.
+    */
+    struct FractionResult
+    {
+        /*
+         * @brief The result of the operation (0/1 if the operation failed).
+        */
+        Fraction value;
+
+        /*
+         * @brief The error code of the operation (FractionError::None if the operation succeeded).
+        */
+        FractionError error;
+
+        /*
+         * @brief Checks whether the operation succeeded.
+         * @return True if the operation succeeded, false otherwise.
+        */
+        bool has_value() const noexcept { return error == FractionError::None; }
+
+        explicit operator bool() const noexcept { return has_value(); }
     };
 
-}
\ No newline at end of file
+    /*
+     * @brief Adds two fractions without throwing.
+     * @param a The first fraction.
+     * @param b The second fraction.
+     * @return FractionResult The sum, or FractionError::Overflow if it doesn't fit in a fraction.
+    */
+    FractionResult checked_add(const Fraction& a, const Fraction& b) noexcept;
+
+    /*
+     * @brief Subtracts two fractions without throwing.
+     * @param a The first fraction.
+     * @param b The second fraction.
+     * @return FractionResult The difference, or FractionError::Overflow if it doesn't fit in a fraction.
+    */
+    FractionResult checked_sub(const Fraction& a, const Fraction& b) noexcept;
+
+    /*
+     * @brief Multiplies two fractions without throwing.
+     * @param a The first fraction.
+     * @param b The second fraction.
+     * @return FractionResult The product, or FractionError::Overflow if it doesn't fit in a fraction.
+    */
+    FractionResult checked_mul(const Fraction& a, const Fraction& b) noexcept;
+
+    /*
+     * @brief Divides two fractions without throwing.
+     * @param a The dividend.
+     * @param b The divisor.
+     * @return FractionResult The quotient, FractionError::DivisionByZero if b is 0, or FractionError::Overflow if it doesn't fit in a fraction.
+    */
+    FractionResult checked_div(const Fraction& a, const Fraction& b) noexcept;
+}
+
+#endif
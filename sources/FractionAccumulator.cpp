@@ -0,0 +1,215 @@
+/*
+ *  Software Systems CPP Course Assignment 3
+ *  Copyright (C) 2023  Roy Simanovich
+ * 
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ * 
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <https://www.gnu.org/licenses/>.
+*/
+
+#include <numeric>
+#include <stdexcept>
+#include "FractionAccumulator.hpp"
+#include "Overflow.hpp"
+#include "FractionStats.hpp"
+
+using namespace std;
+
+namespace ariel
+{
+    FractionAccumulator::FractionAccumulator(): _lcm(1), _lcm_overflow(false), _pending_denominator(0), _pending_sum(0), _count(0) {}
+
+    void FractionAccumulator::__flush() {
+        if (_pending_denominator == 0)
+            return;
+
+        auto [group, inserted] = _groups.try_emplace(_pending_denominator, 0);
+        long long sum = 0;
+
+        // The sum is only stored if it didn't overflow, so a throw leaves the accumulator as it was.
+        if (overflow::add(group->second, _pending_sum, sum))
+        {
+            FRACTION_COUNT(overflows);
+            FRACTION_COUNT(exceptions);
+            throw overflow_error("Accumulator numerator sum overflow");
+        }
+
+        group->second = sum;
+
+        // A new denominator, so the running LCM has to be updated.
+        if (inserted && !_lcm_overflow && overflow::mul(_lcm / gcd(_lcm, _pending_denominator), _pending_denominator, _lcm))
+        {
+            FRACTION_COUNT(overflows);
+            _lcm_overflow = true;
+        }
+
+        _pending_denominator = 0;
+        _pending_sum = 0;
+    }
+
+    void FractionAccumulator::__add(long long numerator, long long denominator) {
+        if (denominator != _pending_denominator)
+        {
+            __flush();
+            _pending_denominator = denominator;
+        }
+
+        long long sum = 0;
+
+        if (overflow::add(_pending_sum, numerator, sum))
+        {
+            FRACTION_COUNT(overflows);
+            FRACTION_COUNT(exceptions);
+            throw overflow_error("Accumulator numerator sum overflow");
+        }
+
+        _pending_sum = sum;
+    }
+
+    void FractionAccumulator::add(const Fraction& fraction) {
+        long long numerator = fraction.numerator();
+        long long denominator = fraction.denominator();
+
+        if (denominator < 0)
+        {
+            numerator = -numerator;
+            denominator = -denominator;
+        }
+
+        __add(numerator, denominator);
+        _count++;
+    }
+
+    void FractionAccumulator::merge(const FractionAccumulator& other) {
+        // Adding to the groups can rehash them, so merging into itself goes through a snapshot.
+        if (&other == this)
+        {
+            FractionAccumulator snapshot(other);
+            merge(snapshot);
+            return;
+        }
+
+        for (const auto& [denominator, sum] : other._groups)
+            __add(sum, denominator);
+
+        if (other._pending_denominator != 0)
+            __add(other._pending_sum, other._pending_denominator);
+
+        _count += other._count;
+    }
+
+    Fraction FractionAccumulator::result() const {
+        long long lcm = _lcm;
+        bool lcm_overflow = _lcm_overflow;
+
+        if (_pending_denominator != 0 && _groups.find(_pending_denominator) == _groups.end() && !lcm_overflow)
+            lcm_overflow = overflow::mul(lcm / gcd(lcm, _pending_denominator), _pending_denominator, lcm);
+
+        long long numerator = 0;
+        long long denominator = 1;
+
+        // Fast path: scale every group to the common denominator with plain multiply-adds.
+        bool fast_overflow = lcm_overflow;
+        auto scale_add = [&](long long sum, long long den) {
+            long long scaled = 0;
+            fast_overflow = fast_overflow || overflow::mul(sum, lcm / den, scaled) || overflow::add(numerator, scaled, numerator);
+        };
+
+        if (!fast_overflow)
+        {
+            for (const auto& [den, sum] : _groups)
+                scale_add(sum, den);
+
+            if (_pending_denominator != 0)
+                scale_add(_pending_sum, _pending_denominator);
+
+            denominator = lcm;
+        }
+
+        // Slow path: merge the groups pairwise, reducing after each step to keep the intermediates small.
+        if (fast_overflow)
+        {
+            FRACTION_COUNT(overflows);
+            numerator = 0;
+            denominator = 1;
+
+            auto reduce_add = [&](long long sum, long long den) {
+                long long g = gcd(sum, den);
+                sum /= g;
+                den /= g;
+
+                g = gcd(denominator, den);
+
+                long long left = 0, right = 0, new_denominator = 0;
+
+                if (overflow::mul(numerator, den / g, left) ||
+                    overflow::mul(sum, denominator / g, right) ||
+                    overflow::add(left, right, numerator) ||
+                    overflow::mul(denominator / g, den, new_denominator))
+                {
+                    FRACTION_COUNT(overflows);
+                    FRACTION_COUNT(exceptions);
+                    throw overflow_error("Accumulator result overflow");
+                }
+
+                denominator = new_denominator;
+                g = gcd(numerator, denominator);
+                numerator /= g;
+                denominator /= g;
+            };
+
+            for (const auto& [den, sum] : _groups)
+                reduce_add(sum, den);
+
+            if (_pending_denominator != 0)
+                reduce_add(_pending_sum, _pending_denominator);
+        }
+
+        long long g = gcd(numerator, denominator);
+        numerator /= g;
+        denominator /= g;
+
+        if (!overflow::fits_int(numerator) || !overflow::fits_int(denominator))
+        {
+            FRACTION_COUNT(overflows);
+            FRACTION_COUNT(exceptions);
+            throw overflow_error("Accumulator result doesn't fit in a fraction");
+        }
+
+        return Fraction(static_cast<int>(numerator), static_cast<int>(denominator));
+    }
+
+    void FractionAccumulator::reset() {
+        _groups.clear();
+        _lcm = 1;
+        _lcm_overflow = false;
+        _pending_denominator = 0;
+        _pending_sum = 0;
+        _count = 0;
+    }
+
+    size_t FractionAccumulator::groups() const {
+        if (_pending_denominator != 0 && _groups.find(_pending_denominator) == _groups.end())
+            return _groups.size() + 1;
+
+        return _groups.size();
+    }
+
+    FractionAccumulator& FractionAccumulator::operator+=(const Fraction& fraction) {
+        add(fraction);
+        return *this;
+    }
+
+    FractionAccumulator& FractionAccumulator::operator+=(const FractionAccumulator& other) {
+        merge(other);
+        return *this;
+    }
+}
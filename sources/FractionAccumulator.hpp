@@ -0,0 +1,144 @@
+/*
+ *  Software Systems CPP Course Assignment 3
+ *  Copyright (C) 2023  Roy Simanovich
+ * 
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ * 
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <https://www.gnu.org/licenses/>.
+*/
+
+#ifndef _FRACTIONACCUMULATOR_HPP
+#define _FRACTIONACCUMULATOR_HPP
+
+#include <cstddef>
+#include <unordered_map>
+#include "Fraction.hpp"
+
+namespace ariel
+{
+    class FractionAccumulator
+    {
+        private:
+            /*
+             * @brief The running sums of the numerators, grouped by their denominator.
+             * @note The key is the (positive) denominator, the value is the sum of all the numerators with that denominator.
+            */
+            std::unordered_map<long long, long long> _groups;
+
+            /*
+             * @brief The running least common multiple of all the denominators seen so far.
+             * @note Only valid while _lcm_overflow is false.
+            */
+            long long _lcm;
+
+            /*
+             * @brief True if the running LCM doesn't fit in a long long anymore.
+             * @note In that case result() falls back to a pairwise reducing merge of the groups.
+            */
+            bool _lcm_overflow;
+
+            /*
+             * @brief The denominator of the pending group.
+             * @note Consecutive inputs with the same denominator are summed here and skip the hash lookup.
+             * @note 0 means there is no pending group.
+            */
+            long long _pending_denominator;
+
+            /*
+             * @brief The numerator sum of the pending group.
+            */
+            long long _pending_sum;
+
+            /*
+             * @brief The number of fractions added so far.
+            */
+            std::size_t _count;
+
+            /*
+             * @brief Adds a numerator to the group of its denominator.
+             * @param numerator The numerator to add.
+             * @param denominator The denominator of the group (must be positive).
+             * @throw overflow_error if the numerator sum of the group overflows.
+            */
+            void __add(long long numerator, long long denominator);
+
+            /*
+             * @brief Moves the pending group into the group table.
+             * @throw overflow_error if the numerator sum of the group overflows.
+            */
+            void __flush();
+
+        public:
+            /*
+             * @brief Default constructor of the FractionAccumulator class.
+             * @note The default accumulator is empty and its result is 0/1.
+            */
+            FractionAccumulator();
+
+            /*
+             * @brief Adds a fraction to the accumulator.
+             * @param fraction The fraction to add.
+             * @throw overflow_error if the numerator sum of the fraction's denominator group overflows.
+             * @note This is a plain integer add; no GCD is computed.
+            */
+            void add(const Fraction& fraction);
+
+            /*
+             * @brief Merges another accumulator into this one.
+             * @param other The accumulator to merge.
+             * @throw overflow_error if a numerator sum overflows.
+             * @note Partial sums (e.g. of different threads) can be merged in any order with the same result.
+             * @note Merging an accumulator into itself doubles its sum.
+            */
+            void merge(const FractionAccumulator& other);
+
+            /*
+             * @brief Returns the exact sum of all the fractions added so far.
+             * @return Fraction The reduced sum.
+             * @throw overflow_error if the reduced sum doesn't fit in a Fraction.
+             * @note This is the only place the sum is reduced.
+            */
+            Fraction result() const;
+
+            /*
+             * @brief Clears the accumulator.
+            */
+            void reset();
+
+            /*
+             * @brief Returns the number of fractions added so far.
+             * @return std::size_t The number of fractions added so far (including merged ones).
+            */
+            std::size_t count() const { return _count; }
+
+            /*
+             * @brief Returns the number of distinct denominators seen so far.
+             * @return std::size_t The number of denominator groups.
+            */
+            std::size_t groups() const;
+
+            /*
+             * @brief Adds a fraction to the accumulator.
+             * @param fraction The fraction to add.
+             * @return FractionAccumulator& The accumulator.
+            */
+            FractionAccumulator& operator+=(const Fraction& fraction);
+
+            /*
+             * @brief Merges another accumulator into this one.
+             * @param other The accumulator to merge.
+             * @return FractionAccumulator& The accumulator.
+            */
+            FractionAccumulator& operator+=(const FractionAccumulator& other);
+    };
+}
+
+#endif
@@ -0,0 +1,113 @@
+/*
+ *  Software Systems CPP Course Assignment 3
+ *  Copyright (C) 2023  Roy Simanovich
+ * 
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ * 
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <https://www.gnu.org/licenses/>.
+*/
+
+#include <stdexcept>
+#include "FractionAtomic.hpp"
+
+using namespace std;
+
+namespace ariel
+{
+    /*
+     * @brief Derives the memory order of a failed compare-exchange from the order of a successful one, like std::atomic does.
+     * @param order The memory order of a successful exchange.
+     * @return memory_order The order without its release part (a failed exchange doesn't store).
+    */
+    static memory_order __failure_order(memory_order order) noexcept {
+        if (order == memory_order_acq_rel)
+            return memory_order_acquire;
+
+        if (order == memory_order_release)
+            return memory_order_relaxed;
+
+        return order;
+    }
+
+    uint64_t to_bits(const Fraction& fraction) noexcept {
+        return (static_cast<uint64_t>(static_cast<uint32_t>(fraction.numerator())) << 32) | static_cast<uint32_t>(fraction.denominator());
+    }
+
+    Fraction from_bits(uint64_t bits) {
+        return Fraction(static_cast<int32_t>(static_cast<uint32_t>(bits >> 32)), static_cast<int32_t>(static_cast<uint32_t>(bits)));
+    }
+
+    Fraction AtomicFraction::__decode(uint64_t bits) noexcept {
+        return Fraction::__unchecked(static_cast<int32_t>(static_cast<uint32_t>(bits >> 32)), static_cast<int32_t>(static_cast<uint32_t>(bits)));
+    }
+
+    AtomicFraction::AtomicFraction(const Fraction& value) noexcept: _bits(to_bits(value)) {}
+
+    bool AtomicFraction::is_lock_free() const noexcept {
+        return _bits.is_lock_free();
+    }
+
+    Fraction AtomicFraction::load(memory_order order) const noexcept {
+        return __decode(_bits.load(order));
+    }
+
+    void AtomicFraction::store(const Fraction& value, memory_order order) noexcept {
+        _bits.store(to_bits(value), order);
+    }
+
+    Fraction AtomicFraction::exchange(const Fraction& value, memory_order order) noexcept {
+        return __decode(_bits.exchange(to_bits(value), order));
+    }
+
+    bool AtomicFraction::compare_exchange(Fraction& expected, const Fraction& desired, memory_order order) noexcept {
+        return compare_exchange(expected, desired, order, __failure_order(order));
+    }
+
+    bool AtomicFraction::compare_exchange(Fraction& expected, const Fraction& desired, memory_order success, memory_order failure) noexcept {
+        uint64_t bits = to_bits(expected);
+
+        if (_bits.compare_exchange_strong(bits, to_bits(desired), success, failure))
+            return true;
+
+        expected = __decode(bits);
+        return false;
+    }
+
+    Fraction AtomicFraction::__fetch_update(FractionResult (*operation)(const Fraction&, const Fraction&) noexcept, const Fraction& operand, memory_order order) {
+        // The value the operation sees (and may throw on) is read with the same order a failed exchange reloads it with.
+        memory_order failure = __failure_order(order);
+        uint64_t bits = _bits.load(failure);
+
+        while (true)
+        {
+            Fraction current = __decode(bits);
+            FractionResult result = operation(current, operand);
+
+            if (!result)
+            {
+                FRACTION_COUNT(exceptions);
+                throw overflow_error("Atomic fraction update overflow");
+            }
+
+            // On failure bits is reloaded with the current value and the operation is retried.
+            if (_bits.compare_exchange_weak(bits, to_bits(result.value), order, failure))
+                return current;
+        }
+    }
+
+    Fraction AtomicFraction::fetch_add(const Fraction& value, memory_order order) {
+        return __fetch_update(checked_add, value, order);
+    }
+
+    Fraction AtomicFraction::fetch_mul(const Fraction& value, memory_order order) {
+        return __fetch_update(checked_mul, value, order);
+    }
+}
@@ -0,0 +1,164 @@
+/*
+ *  Software Systems CPP Course Assignment 3
+ *  Copyright (C) 2023  Roy Simanovich
+ * 
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ * 
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <https://www.gnu.org/licenses/>.
+*/
+
+#ifndef _FRACTIONATOMIC_HPP
+#define _FRACTIONATOMIC_HPP
+
+#include <atomic>
+#include <cstdint>
+#include "Fraction.hpp"
+
+namespace ariel
+{
+    /*
+     * @brief Packs a fraction into a single 64 bit word.
+     * @param fraction The fraction to pack.
+     * @return std::uint64_t The numerator (two's complement) in the high 32 bits, the denominator in the low 32 bits.
+     * @note Fractions are always reduced with a positive denominator, so equal fractions have equal bits.
+    */
+    std::uint64_t to_bits(const Fraction& fraction) noexcept;
+
+    /*
+     * @brief Unpacks a fraction packed by to_bits.
+     * @param bits The packed fraction.
+     * @return Fraction The unpacked (and reduced) fraction.
+     * @throw invalid_argument if the denominator is 0.
+     * @note Checks and reduces the bits, since they may come from anywhere; AtomicFraction unpacks its own bits without that.
+    */
+    Fraction from_bits(std::uint64_t bits);
+
+    /*
+     * @brief A fraction that many threads can read and update without a lock.
+     * @note The fraction is held packed in a single std::atomic<std::uint64_t>; the updates are CAS loops.
+     * @note Since the packing is canonical, compare_exchange compares values, not just representations.
+    */
+    class AtomicFraction
+    {
+        private:
+            /*
+             * @brief The packed value (see to_bits).
+            */
+            std::atomic<std::uint64_t> _bits;
+
+            /*
+             * @brief Unpacks the bits of this object.
+             * @param bits The packed fraction, always packed by to_bits from a valid Fraction.
+             * @return Fraction The unpacked fraction.
+             * @note The bits are already canonical, so they are unpacked without a check or a reduction.
+            */
+            static Fraction __decode(std::uint64_t bits) noexcept;
+
+            /*
+             * @brief Applies a checked operation in a CAS loop.
+             * @param operation The checked operation, called with the current value and the operand.
+             * @param operand The second operand of the operation.
+             * @param order The memory order of a successful update.
+             * @return Fraction The value before the update.
+             * @throw overflow_error if the result doesn't fit in a Fraction (the value is left unchanged).
+            */
+            Fraction __fetch_update(FractionResult (*operation)(const Fraction&, const Fraction&) noexcept, const Fraction& operand, std::memory_order order);
+
+        public:
+            /*
+             * @brief Whether the atomic is lock-free on every target of this build.
+            */
+            static constexpr bool is_always_lock_free = std::atomic<std::uint64_t>::is_always_lock_free;
+
+            /*
+             * @brief Constructs an atomic fraction.
+             * @param value The initial value (0/1 by default).
+            */
+            AtomicFraction(const Fraction& value = Fraction()) noexcept;
+
+            AtomicFraction(const AtomicFraction& other) = delete;
+            AtomicFraction& operator=(const AtomicFraction& other) = delete;
+
+            /*
+             * @brief Checks whether the operations of this object are lock-free.
+             * @return True if they are lock-free, false otherwise.
+            */
+            bool is_lock_free() const noexcept;
+
+            /*
+             * @brief Reads the value.
+             * @param order The memory order of the load.
+             * @return Fraction The current value.
+            */
+            Fraction load(std::memory_order order = std::memory_order_seq_cst) const noexcept;
+
+            /*
+             * @brief Replaces the value.
+             * @param value The new value.
+             * @param order The memory order of the store.
+            */
+            void store(const Fraction& value, std::memory_order order = std::memory_order_seq_cst) noexcept;
+
+            /*
+             * @brief Replaces the value and returns the old one.
+             * @param value The new value.
+             * @param order The memory order of the exchange.
+             * @return Fraction The value before the exchange.
+            */
+            Fraction exchange(const Fraction& value, std::memory_order order = std::memory_order_seq_cst) noexcept;
+
+            /*
+             * @brief Replaces the value if it is equal to an expected value.
+             * @param expected The expected value, overwritten with the current value if they are not equal.
+             * @param desired The new value.
+             * @param order The memory order of a successful exchange.
+             * @return True if the value was replaced, false otherwise.
+             * @note A failed exchange uses the order without its release part, like std::atomic (acq_rel becomes acquire, release becomes relaxed).
+            */
+            bool compare_exchange(Fraction& expected, const Fraction& desired, std::memory_order order = std::memory_order_seq_cst) noexcept;
+
+            /*
+             * @brief Replaces the value if it is equal to an expected value.
+             * @param expected The expected value, overwritten with the current value if they are not equal.
+             * @param desired The new value.
+             * @param success The memory order of a successful exchange.
+             * @param failure The memory order of a failed exchange (can't be release or acq_rel).
+             * @return True if the value was replaced, false otherwise.
+            */
+            bool compare_exchange(Fraction& expected, const Fraction& desired, std::memory_order success, std::memory_order failure) noexcept;
+
+            /*
+             * @brief Adds to the value.
+             * @param value The fraction to add.
+             * @param order The memory order of the update.
+             * @return Fraction The value before the addition.
+             * @throw overflow_error if the sum doesn't fit in a Fraction (the value is left unchanged).
+            */
+            Fraction fetch_add(const Fraction& value, std::memory_order order = std::memory_order_seq_cst);
+
+            /*
+             * @brief Multiplies the value.
+             * @param value The fraction to multiply by.
+             * @param order The memory order of the update.
+             * @return Fraction The value before the multiplication.
+             * @throw overflow_error if the product doesn't fit in a Fraction (the value is left unchanged).
+            */
+            Fraction fetch_mul(const Fraction& value, std::memory_order order = std::memory_order_seq_cst);
+
+            /*
+             * @brief Reads the value.
+             * @return Fraction The current value.
+            */
+            operator Fraction() const noexcept { return load(); }
+    };
+}
+
+#endif
@@ -0,0 +1,325 @@
+/*
+ *  Software Systems CPP Course Assignment 3
+ *  Copyright (C) 2023  Roy Simanovich
+ * 
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ * 
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <https://www.gnu.org/licenses/>.
+*/
+
+#include <algorithm>
+#include <bit>
+#include <cmath>
+#include <cstdint>
+#include <stdexcept>
+#include <vector>
+#include "BoundedFraction.hpp"
+#include "DyadicFraction.hpp"
+#include "FractionBatch.hpp"
+#include "FractionChunks.hpp"
+#include "FractionMath.hpp"
+#include "FractionParallel.hpp"
+#include "FractionStats.hpp"
+
+using namespace std;
+
+namespace ariel
+{
+    /*
+     * @brief Checks that an input and an output range have the same size.
+     * @throw invalid_argument if they don't.
+    */
+    static void __check_sizes(size_t input, size_t output) {
+        if (input != output)
+        {
+            FRACTION_COUNT(exceptions);
+            throw invalid_argument("Ranges must have the same size");
+        }
+    }
+
+    void axpy(const Fraction& a, span<const Fraction> x, span<Fraction> y) {
+        __check_sizes(x.size(), y.size());
+
+        __for_each_chunk(x.size(), [&](size_t, size_t first, size_t last) {
+            for (size_t i = first; i < last; i++)
+                y[i] = fma(a, x[i], y[i]);
+        });
+    }
+
+    Fraction dot(span<const Fraction> x, span<const Fraction> y) {
+        __check_sizes(x.size(), y.size());
+
+        size_t chunks = __chunks(x.size(), 0);
+        vector<Fraction> partials(chunks);
+
+        __for_each_chunk(x.size(), chunks, [&](size_t index, size_t first, size_t last) {
+            Fraction sum;
+
+            for (size_t i = first; i < last; i++)
+                sum = fma(x[i], y[i], sum);
+
+            partials[index] = sum;
+        });
+
+        return parallel_sum(partials, 1);
+    }
+
+    /*
+     * @brief Estimates 1 / d without a division (for d >= 1).
+     * @param d The number to invert.
+     * @return The reciprocal, within about 4e-8 relative error.
+     * @note A magic-constant initial guess (about 12% off) and three Newton steps, each squaring the error.
+    */
+    static inline float __reciprocal(float d) {
+        float r = bit_cast<float>(0x7EF311C3u - bit_cast<uint32_t>(d));
+
+        r = r * (2.0f - d * r);
+        r = r * (2.0f - d * r);
+        r = r * (2.0f - d * r);
+
+        return r;
+    }
+
+    /*
+     * @brief Estimates 1 / d without a division (for d >= 1).
+     * @param d The number to invert.
+     * @return The reciprocal, within about 1 ulp.
+     * @note Same as the float version, with five Newton steps.
+    */
+    static inline double __reciprocal(double d) {
+        double r = bit_cast<double>(0x7FDE623822FC16E6ull - bit_cast<uint64_t>(d));
+
+        for (int step = 0; step < 5; step++)
+            r = r * (2.0 - d * r);
+
+        return r;
+    }
+
+    /*
+     * @brief Checks whether rounding a double to a float could double-round.
+     * @param value A double quotient of two ints (a normal number in float range).
+     * @return True if the double lies exactly halfway between two floats.
+     * @note Only then can the exact quotient be on the other side of the midpoint than the double says.
+    */
+    static inline bool __float_midpoint(double value) {
+        return (bit_cast<uint64_t>(value) & 0x1FFFFFFFull) == 0x10000000ull;
+    }
+
+    void to_double(span<const Fraction> fractions, span<double> out, ConversionMode mode) {
+        __check_sizes(fractions.size(), out.size());
+
+        __for_each_chunk(fractions.size(), [&](size_t, size_t first, size_t last) {
+            if (mode == ConversionMode::Fast)
+            {
+                for (size_t i = first; i < last; i++)
+                    out[i] = static_cast<double>(fractions[i].numerator()) * __reciprocal(static_cast<double>(fractions[i].denominator()));
+            }
+
+            else
+            {
+                for (size_t i = first; i < last; i++)
+                    out[i] = static_cast<double>(fractions[i].numerator()) / fractions[i].denominator();
+            }
+        });
+    }
+
+    void to_float(span<const Fraction> fractions, span<float> out, ConversionMode mode) {
+        __check_sizes(fractions.size(), out.size());
+
+        __for_each_chunk(fractions.size(), [&](size_t, size_t first, size_t last) {
+            if (mode == ConversionMode::Fast)
+            {
+                for (size_t i = first; i < last; i++)
+                    out[i] = static_cast<float>(fractions[i].numerator()) * __reciprocal(static_cast<float>(fractions[i].denominator()));
+
+                return;
+            }
+
+            size_t midpoints = 0;
+
+            for (size_t i = first; i < last; i++)
+            {
+                double value = static_cast<double>(fractions[i].numerator()) / fractions[i].denominator();
+                midpoints += __float_midpoint(value);
+                out[i] = static_cast<float>(value);
+            }
+
+            // Midpoints are rare, so the fix-up pass almost never runs and the main loop stays branch-free.
+            if (midpoints > 0)
+            {
+                for (size_t i = first; i < last; i++)
+                {
+                    if (__float_midpoint(static_cast<double>(fractions[i].numerator()) / fractions[i].denominator()))
+                        out[i] = fractions[i].to_float();
+                }
+            }
+        });
+    }
+
+    /*
+     * @brief The number of elements the Decimal mode prepares at a time.
+    */
+    static const size_t DECIMAL_BLOCK = 256;
+
+    /*
+     * @brief Checks that a value can be converted to a Fraction at all.
+     * @throw invalid_argument if the value isn't finite.
+     * @throw overflow_error if the value is out of the range of an int.
+    */
+    static void __check_value(double value) {
+        if (!isfinite(value))
+        {
+            FRACTION_COUNT(exceptions);
+            throw invalid_argument("Value isn't finite");
+        }
+
+        if (fabs(value) >= 0x1p31)
+        {
+            FRACTION_COUNT(overflows);
+            FRACTION_COUNT(exceptions);
+            throw overflow_error("Value doesn't fit in a fraction");
+        }
+    }
+
+    /*
+     * @brief Converts a value to the closest fraction with a bounded denominator.
+     * @param value The value (finite and in the range of an int).
+     * @param max_denominator The largest denominator.
+     * @return Fraction The closest fraction.
+     * @note The value is taken with 62 fraction bits (exact unless it is below about 2^-9), far finer than any bounded denominator can resolve.
+    */
+    static Fraction __bounded(double value, int max_denominator) {
+        int exponent;
+        frexp(value, &exponent);
+
+        int shift = 62 - max(exponent, 0);
+        return limit_denominator(llround(ldexp(value, shift)), 1LL << shift, max_denominator);
+    }
+
+    /*
+     * @brief Checks whether a float is integral, like the number != (int)number test of Fraction(float).
+     * @param value The float to check.
+     * @return uint32_t All ones if the float is integral, otherwise zero.
+     * @note Adding and subtracting 2^23 rounds magnitudes below 2^23 to an integer, and floats of 2^23 and up are always integral.
+     * @note Only compares and bit operations, no casts, so it is safe for any float and the compiler doesn't turn it into a branch.
+    */
+    static inline uint32_t __integral(float value) {
+        float magnitude = fabsf(value);
+        bool large = bit_cast<uint32_t>(magnitude) >= bit_cast<uint32_t>(0x1p23f);
+        bool whole = ((magnitude + 0x1p23f) - 0x1p23f) == magnitude;
+        return -static_cast<uint32_t>(large | whole);
+    }
+
+    /*
+     * @brief Converts floats the way Fraction(float) does.
+     * @param values The floats to convert.
+     * @param out The converted fractions.
+     * @note Fraction(float) multiplies by 10 until the value is integral, at most 3 times; here all 3 products are computed and the first integral one is selected, so the block loop has no branches.
+    */
+    static void __decimal(span<const float> values, span<Fraction> out) {
+        int numerators[DECIMAL_BLOCK];
+        int denominators[DECIMAL_BLOCK];
+
+        for (size_t block = 0; block < values.size(); block += DECIMAL_BLOCK)
+        {
+            size_t size = min(DECIMAL_BLOCK, values.size() - block);
+
+            for (size_t i = 0; i < size; i++)
+                __check_value(values[block + i]);
+
+            for (size_t i = 0; i < size; i++)
+            {
+                // The same float multiplications as the constructor, so the roundings match.
+                float a0 = values[block + i], a1 = a0 * 10, a2 = a1 * 10, a3 = a2 * 10;
+
+                // One mask per candidate, only the first integral one set. Blended with bit operations, since selects get turned back into branches.
+                uint32_t m0 = __integral(a0);
+                uint32_t m1 = __integral(a1) & ~m0;
+                uint32_t m2 = __integral(a2) & ~(m0 | m1);
+                uint32_t m3 = ~(m0 | m1 | m2);
+
+                uint32_t bits = (bit_cast<uint32_t>(a0) & m0) | (bit_cast<uint32_t>(a1) & m1) | (bit_cast<uint32_t>(a2) & m2) | (bit_cast<uint32_t>(a3) & m3);
+                uint32_t denominator = (1 & m0) | (10 & m1) | (100 & m2) | (1000 & m3);
+
+                // In range: the selected candidate is a0 (checked), or at most 10 times a candidate below 2^23.
+                float number = bit_cast<float>(bits);
+
+                numerators[i] = static_cast<int>(number);
+                denominators[i] = static_cast<int>(denominator);
+            }
+
+            for (size_t i = 0; i < size; i++)
+                out[block + i] = Fraction(numerators[i], denominators[i]);
+        }
+    }
+
+    /*
+     * @brief Converts a range of values in one of the modes.
+     * @param values The values to convert.
+     * @param out The converted fractions.
+     * @param mode The conversion mode.
+     * @param max_denominator The largest denominator of the Bounded mode.
+    */
+    template <typename T>
+    static void __from_floating(span<const T> values, span<Fraction> out, FloatConversion mode, int max_denominator) {
+        __check_sizes(values.size(), out.size());
+
+        if (mode == FloatConversion::Bounded && max_denominator <= 0)
+        {
+            FRACTION_COUNT(exceptions);
+            throw invalid_argument("Maximal denominator must be positive");
+        }
+
+        __for_each_chunk(values.size(), [&](size_t, size_t first, size_t last) {
+            if (mode == FloatConversion::Decimal)
+            {
+                if constexpr (is_same_v<T, float>)
+                    __decimal(values.subspan(first, last - first), out.subspan(first, last - first));
+
+                else
+                {
+                    float block[DECIMAL_BLOCK];
+
+                    for (size_t i = first; i < last; i += DECIMAL_BLOCK)
+                    {
+                        size_t size = min(DECIMAL_BLOCK, last - i);
+
+                        for (size_t j = 0; j < size; j++)
+                            block[j] = static_cast<float>(values[i + j]);
+
+                        __decimal(span<const float>(block, size), out.subspan(i, size));
+                    }
+                }
+
+                return;
+            }
+
+            for (size_t i = first; i < last; i++)
+            {
+                __check_value(values[i]);
+
+                if (mode == FloatConversion::Exact)
+                    out[i] = Fraction(DyadicFraction::from_double(values[i]));
+
+                else
+                    out[i] = __bounded(values[i], max_denominator);
+            }
+        });
+    }
+
+    void from_float(span<const float> values, span<Fraction> out, FloatConversion mode, int max_denominator) {
+        __from_floating(values, out, mode, max_denominator);
+    }
+
+    void from_double(span<const double> values, span<Fraction> out, FloatConversion mode, int max_denominator) {
+        __from_floating(values, out, mode, max_denominator);
+    }
+}
@@ -0,0 +1,111 @@
+/*
+ *  Software Systems CPP Course Assignment 3
+ *  Copyright (C) 2023  Roy Simanovich
+ * 
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ * 
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <https://www.gnu.org/licenses/>.
+*/
+
+#ifndef _FRACTIONBATCH_HPP
+#define _FRACTIONBATCH_HPP
+
+#include <span>
+#include "Fraction.hpp"
+
+namespace ariel
+{
+    /*
+     * @brief Calculates y = a * x + y element-wise.
+     * @param a The scalar factor.
+     * @param x The fractions to scale.
+     * @param y The fractions to add to (and the result).
+     * @throw invalid_argument if x and y don't have the same size.
+     * @throw overflow_error if a result doesn't fit in a Fraction.
+     * @note Every element is a single fma(); large ranges are split over the default thread pool.
+    */
+    void axpy(const Fraction& a, std::span<const Fraction> x, std::span<Fraction> y);
+
+    /*
+     * @brief Calculates the dot product of two ranges of fractions.
+     * @param x The first range.
+     * @param y The second range.
+     * @return Fraction The exact, reduced sum of x[i] * y[i].
+     * @throw invalid_argument if x and y don't have the same size.
+     * @throw overflow_error if a partial result doesn't fit in a Fraction.
+     * @note Every element is a single fma() into the running sum; large ranges are split over the default thread pool.
+    */
+    Fraction dot(std::span<const Fraction> x, std::span<const Fraction> y);
+
+    /*
+     * @brief The accuracy modes of the batch conversions to floating point.
+    */
+    enum class ConversionMode
+    {
+        Exact,  // Correctly rounded, like Fraction::to_double and Fraction::to_float.
+        Fast    // A reciprocal estimate refined by Newton steps, then a multiply: no division at all, within a few ulps.
+    };
+
+    /*
+     * @brief Converts fractions to doubles element-wise.
+     * @param fractions The fractions to convert.
+     * @param out The converted values.
+     * @param mode The accuracy mode (correctly rounded by default).
+     * @throw invalid_argument if fractions and out don't have the same size.
+     * @note Both modes are branch-free loops the compiler vectorizes; large ranges are split over the default thread pool.
+    */
+    void to_double(std::span<const Fraction> fractions, std::span<double> out, ConversionMode mode = ConversionMode::Exact);
+
+    /*
+     * @brief Converts fractions to floats element-wise.
+     * @param fractions The fractions to convert.
+     * @param out The converted values.
+     * @param mode The accuracy mode (correctly rounded by default).
+     * @throw invalid_argument if fractions and out don't have the same size.
+     * @note The exact mode rounds the double quotient, and only redoes the rare elements where that could double-round with Fraction::to_float.
+    */
+    void to_float(std::span<const Fraction> fractions, std::span<float> out, ConversionMode mode = ConversionMode::Exact);
+
+    /*
+     * @brief The modes of the batch conversions from floating point.
+    */
+    enum class FloatConversion
+    {
+        Exact,      // The exact binary value; throws overflow_error if it doesn't fit in a Fraction (e.g. 0.1f is 13421773/134217728).
+        Decimal,    // Up to 3 decimal digits, truncated: the same result as the Fraction(float) constructor.
+        Bounded     // The closest fraction with a denominator of at most max_denominator (see limit_denominator).
+    };
+
+    /*
+     * @brief Converts floats to fractions element-wise.
+     * @param values The floats to convert.
+     * @param out The converted fractions.
+     * @param mode The conversion mode (Fraction(float) semantics by default).
+     * @param max_denominator The largest denominator of the Bounded mode.
+     * @throw invalid_argument if values and out don't have the same size, or a value isn't finite.
+     * @throw overflow_error if a converted value doesn't fit in a Fraction.
+     * @note The Decimal mode picks the number of digits branch-free, in blocks the compiler vectorizes; large ranges are split over the default thread pool.
+    */
+    void from_float(std::span<const float> values, std::span<Fraction> out, FloatConversion mode = FloatConversion::Decimal, int max_denominator = 1000);
+
+    /*
+     * @brief Converts doubles to fractions element-wise.
+     * @param values The doubles to convert.
+     * @param out The converted fractions.
+     * @param mode The conversion mode (the Decimal mode converts to float first, like Fraction(float)).
+     * @param max_denominator The largest denominator of the Bounded mode.
+     * @throw invalid_argument if values and out don't have the same size, or a value isn't finite.
+     * @throw overflow_error if a converted value doesn't fit in a Fraction.
+    */
+    void from_double(std::span<const double> values, std::span<Fraction> out, FloatConversion mode = FloatConversion::Decimal, int max_denominator = 1000);
+}
+
+#endif
@@ -0,0 +1,87 @@
+/*
+ *  Software Systems CPP Course Assignment 3
+ *  Copyright (C) 2023  Roy Simanovich
+ * 
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ * 
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <https://www.gnu.org/licenses/>.
+*/
+
+#ifndef _FRACTIONCHUNKS_HPP
+#define _FRACTIONCHUNKS_HPP
+
+#include <algorithm>
+#include <cstddef>
+#include "ThreadPool.hpp"
+
+/*
+ * Chunking of the batch and parallel kernels over the default thread pool.
+ *
+ * Internal header, only included by the translation units of the library.
+*/
+
+namespace ariel
+{
+    /*
+     * @brief The minimal number of elements a chunk gets, so small ranges don't pay for threads they don't need.
+    */
+    inline constexpr std::size_t MIN_CHUNK = 4096;
+
+    /*
+     * @brief Calculates the number of chunks to split a range into.
+     * @param size The size of the range.
+     * @param threads The requested number of threads (0 means one per hardware thread).
+     * @return std::size_t The number of chunks (at least 1).
+    */
+    inline std::size_t __chunks(std::size_t size, unsigned int threads) {
+        std::size_t requested = (threads == 0) ? ThreadPool::instance().workers() + 1 : threads;
+        std::size_t useful = (size + MIN_CHUNK - 1) / MIN_CHUNK;
+
+        return std::max<std::size_t>(1, std::min(requested, useful));
+    }
+
+    /*
+     * @brief Runs a function over [0, size) in chunks on the default thread pool.
+     * @param size The number of elements.
+     * @param chunks The number of chunks (at least 1).
+     * @param function The function to run on every chunk, with the chunk index, its first element and one past its last element.
+     * @throw Rethrows the first exception thrown by the function.
+     * @note A single chunk runs on the calling thread, without going through the pool.
+    */
+    template <typename Function>
+    inline void __for_each_chunk(std::size_t size, std::size_t chunks, Function function) {
+        std::size_t chunk_size = (size + chunks - 1) / chunks;
+
+        if (chunks == 1)
+        {
+            function(0, 0, size);
+            return;
+        }
+
+        ThreadPool::instance().parallel_for(chunks, [&](std::size_t index) {
+            std::size_t first = std::min(size, index * chunk_size);
+            function(index, first, std::min(size, first + chunk_size));
+        });
+    }
+
+    /*
+     * @brief Runs a function over [0, size) in one chunk per hardware thread (at most), on the default thread pool.
+     * @param size The number of elements.
+     * @param function The function to run on every chunk, with the chunk index, its first element and one past its last element.
+     * @throw Rethrows the first exception thrown by the function.
+    */
+    template <typename Function>
+    inline void __for_each_chunk(std::size_t size, Function function) {
+        __for_each_chunk(size, __chunks(size, 0), function);
+    }
+}
+
+#endif
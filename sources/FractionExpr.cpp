@@ -0,0 +1,145 @@
+/*
+ *  Software Systems CPP Course Assignment 3
+ *  Copyright (C) 2023  Roy Simanovich
+ * 
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ * 
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <https://www.gnu.org/licenses/>.
+*/
+
+#include <numeric>
+#include <stdexcept>
+#include "FractionExpr.hpp"
+#include "Overflow.hpp"
+#include "FractionStats.hpp"
+
+using namespace std;
+
+namespace ariel
+{
+    namespace expr
+    {
+        /*
+         * @brief Reduces an unreduced fraction in place.
+         * @param value The fraction to reduce.
+         * @return Raw The reduced fraction.
+        */
+        static Raw __reduce(Raw value) {
+            long long g = gcd(value.numerator, value.denominator);
+            return {value.numerator / g, value.denominator / g};
+        }
+
+        /*
+         * @brief Adds or subtracts two unreduced fractions.
+         * @param a The first fraction.
+         * @param b The second fraction.
+         * @param sign 1 to add, -1 to subtract.
+         * @return Raw The unreduced result.
+         * @throw overflow_error if the result doesn't fit even after reduction.
+        */
+        static Raw __add(Raw a, Raw b, long long sign) {
+            Raw result{0, 0};
+            long long left = 0, right = 0;
+
+            b.numerator *= sign;
+
+            // Same denominator: a plain numerator add.
+            if (a.denominator == b.denominator && !overflow::add(a.numerator, b.numerator, result.numerator))
+                return {result.numerator, a.denominator};
+
+            if (!overflow::mul(a.numerator, b.denominator, left) &&
+                !overflow::mul(b.numerator, a.denominator, right) &&
+                !overflow::add(left, right, result.numerator) &&
+                !overflow::mul(a.denominator, b.denominator, result.denominator))
+                return result;
+
+            // Overflow: reduce the operands and add over the LCM of the denominators.
+            FRACTION_COUNT(overflows);
+            a = __reduce(a);
+            b = __reduce(b);
+
+            long long g = gcd(a.denominator, b.denominator);
+
+            if (overflow::mul(a.numerator, b.denominator / g, left) ||
+                overflow::mul(b.numerator, a.denominator / g, right) ||
+                overflow::add(left, right, result.numerator) ||
+                overflow::mul(a.denominator / g, b.denominator, result.denominator))
+            {
+                FRACTION_COUNT(overflows);
+                FRACTION_COUNT(exceptions);
+                throw overflow_error("Expression overflow");
+            }
+
+            return result;
+        }
+
+        Raw add(Raw a, Raw b) {
+            return __add(a, b, 1);
+        }
+
+        Raw sub(Raw a, Raw b) {
+            return __add(a, b, -1);
+        }
+
+        Raw mul(Raw a, Raw b) {
+            Raw result{0, 0};
+
+            if (!overflow::mul(a.numerator, b.numerator, result.numerator) &&
+                !overflow::mul(a.denominator, b.denominator, result.denominator))
+                return result;
+
+            // Overflow: reduce the operands, then cross-cancel before multiplying.
+            FRACTION_COUNT(overflows);
+            a = __reduce(a);
+            b = __reduce(b);
+
+            long long g1 = gcd(a.numerator, b.denominator);
+            long long g2 = gcd(b.numerator, a.denominator);
+
+            if (overflow::mul(a.numerator / g1, b.numerator / g2, result.numerator) ||
+                overflow::mul(a.denominator / g2, b.denominator / g1, result.denominator))
+            {
+                FRACTION_COUNT(overflows);
+                FRACTION_COUNT(exceptions);
+                throw overflow_error("Expression overflow");
+            }
+
+            return result;
+        }
+
+        Raw div(Raw a, Raw b) {
+            if (b.numerator == 0)
+            {
+                FRACTION_COUNT(exceptions);
+                throw invalid_argument("Can't divide by zero");
+            }
+
+            // Multiply by the reciprocal, keeping the denominator positive.
+            if (b.numerator < 0)
+                return mul(a, {-b.denominator, -b.numerator});
+
+            return mul(a, {b.denominator, b.numerator});
+        }
+
+        Fraction reduce(Raw value) {
+            value = __reduce(value);
+
+            if (!overflow::fits_int(value.numerator) || !overflow::fits_int(value.denominator))
+            {
+                FRACTION_COUNT(overflows);
+                FRACTION_COUNT(exceptions);
+                throw overflow_error("Expression result doesn't fit in a fraction");
+            }
+
+            return Fraction(static_cast<int>(value.numerator), static_cast<int>(value.denominator));
+        }
+    }
+}
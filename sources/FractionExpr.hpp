@@ -0,0 +1,203 @@
+/*
+ *  Software Systems CPP Course Assignment 3
+ *  Copyright (C) 2023  Roy Simanovich
+ * 
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ * 
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <https://www.gnu.org/licenses/>.
+*/
+
+#ifndef _FRACTIONEXPR_HPP
+#define _FRACTIONEXPR_HPP
+
+#include <concepts>
+#include <type_traits>
+#include "Fraction.hpp"
+
+namespace ariel
+{
+    /*
+     * @brief Expression templates over Fraction.
+     * @note An expression such as lazy(a) + b - 1 is captured as a tree instead of materializing a reduced Fraction after every operator.
+     * @note The tree is evaluated on unreduced wide (long long) values, sharing denominators where they are equal, and reduced once on conversion to Fraction.
+     * @note Intermediates are only reduced if they would overflow; if they still overflow, the evaluation throws overflow_error.
+    */
+    namespace expr
+    {
+        /*
+         * @brief An unreduced fraction with wide members, the value of a (sub)expression.
+         * @note The denominator is always positive.
+        */
+        struct Raw
+        {
+            long long numerator;
+            long long denominator;
+        };
+
+        /*
+         * @brief Adds two unreduced fractions.
+         * @throw overflow_error if the sum doesn't fit even after reduction.
+        */
+        Raw add(Raw a, Raw b);
+
+        /*
+         * @brief Subtracts two unreduced fractions.
+         * @throw overflow_error if the difference doesn't fit even after reduction.
+        */
+        Raw sub(Raw a, Raw b);
+
+        /*
+         * @brief Multiplies two unreduced fractions.
+         * @throw overflow_error if the product doesn't fit even after reducing the operands and cross-cancelling.
+        */
+        Raw mul(Raw a, Raw b);
+
+        /*
+         * @brief Divides two unreduced fractions.
+         * @throw invalid_argument if b is zero.
+         * @throw overflow_error if the quotient doesn't fit even after reducing the operands and cross-cancelling.
+        */
+        Raw div(Raw a, Raw b);
+
+        /*
+         * @brief Reduces an unreduced fraction to a Fraction.
+         * @throw overflow_error if the reduced fraction doesn't fit in a Fraction.
+        */
+        Fraction reduce(Raw value);
+
+        /*
+         * @brief Base class of all the expression nodes (CRTP).
+         * @note Converting an expression to a Fraction evaluates it.
+        */
+        template <typename Derived>
+        class Expression
+        {
+            public:
+                /*
+                 * @brief Evaluates the expression.
+                 * @return Fraction The reduced value of the expression.
+                */
+                operator Fraction() const {
+                    return reduce(static_cast<const Derived&>(*this).eval());
+                }
+        };
+
+        /*
+         * @brief True for expression nodes.
+        */
+        template <typename T>
+        concept Node = std::derived_from<T, Expression<T>>;
+
+        /*
+         * @brief True for the plain operands an expression accepts (Fraction, integers and floating point numbers).
+        */
+        template <typename T>
+        concept Scalar = std::same_as<T, Fraction> || std::integral<T> || std::floating_point<T>;
+
+        /*
+         * @brief A leaf of the expression tree.
+         * @note Floating point operands are converted like the Fraction(float) constructor does, so lazy and eager results agree.
+        */
+        class Term: public Expression<Term>
+        {
+            private:
+                Raw _value;
+
+            public:
+                explicit Term(const Fraction& value): _value{value.numerator(), value.denominator()} {}
+
+                template <std::integral T>
+                explicit Term(T value): _value{static_cast<long long>(value), 1} {}
+
+                template <std::floating_point T>
+                explicit Term(T value): Term(Fraction(static_cast<float>(value))) {}
+
+                Raw eval() const { return _value; }
+        };
+
+        /*
+         * @brief An inner node of the expression tree.
+         * @note The children are held by value, so expressions over temporaries are safe to keep.
+        */
+        template <Raw (*Operation)(Raw, Raw), typename Left, typename Right>
+        class Binary: public Expression<Binary<Operation, Left, Right>>
+        {
+            private:
+                Left _left;
+                Right _right;
+
+            public:
+                Binary(const Left& left, const Right& right): _left(left), _right(right) {}
+
+                Raw eval() const { return Operation(_left.eval(), _right.eval()); }
+        };
+
+        /*
+         * @brief Wraps an operand as an expression node.
+        */
+        template <Node T>
+        const T& node(const T& value) { return value; }
+
+        template <Scalar T>
+        Term node(const T& value) { return Term(value); }
+
+        /*
+         * @brief True if the operands form an expression (at least one of them is already an expression node).
+        */
+        template <typename Left, typename Right>
+        concept Operands = (Node<Left> && (Node<Right> || Scalar<Right>)) || (Scalar<Left> && Node<Right>);
+
+        template <typename T>
+        using Node_t = std::decay_t<decltype(node(std::declval<const T&>()))>;
+
+        template <typename Left, typename Right> requires Operands<Left, Right>
+        Binary<add, Node_t<Left>, Node_t<Right>> operator+(const Left& left, const Right& right) {
+            return {node(left), node(right)};
+        }
+
+        template <typename Left, typename Right> requires Operands<Left, Right>
+        Binary<sub, Node_t<Left>, Node_t<Right>> operator-(const Left& left, const Right& right) {
+            return {node(left), node(right)};
+        }
+
+        template <typename Left, typename Right> requires Operands<Left, Right>
+        Binary<mul, Node_t<Left>, Node_t<Right>> operator*(const Left& left, const Right& right) {
+            return {node(left), node(right)};
+        }
+
+        template <typename Left, typename Right> requires Operands<Left, Right>
+        Binary<div, Node_t<Left>, Node_t<Right>> operator/(const Left& left, const Right& right) {
+            return {node(left), node(right)};
+        }
+    }
+
+    /*
+     * @brief Starts an expression.
+     * @param value The first operand of the expression.
+     * @return expr::Term The expression leaf holding the operand.
+     * @note Example: Fraction c = lazy(a) + b - 1; evaluates the whole right side with a single reduction.
+    */
+    inline expr::Term lazy(const Fraction& value) {
+        return expr::Term(value);
+    }
+
+    /*
+     * @brief Evaluates an expression.
+     * @param expression The expression to evaluate.
+     * @return Fraction The reduced value of the expression.
+    */
+    template <expr::Node T>
+    Fraction evaluate(const T& expression) {
+        return expression;
+    }
+}
+
+#endif
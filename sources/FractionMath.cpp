@@ -0,0 +1,305 @@
+/*
+ *  Software Systems CPP Course Assignment 3
+ *  Copyright (C) 2023  Roy Simanovich
+ * 
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ * 
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <https://www.gnu.org/licenses/>.
+*/
+
+#include <limits>
+#include <numeric>
+#include <stdexcept>
+#include <utility>
+#include "FractionMath.hpp"
+#include "FractionStats.hpp"
+#include "Overflow.hpp"
+
+using namespace std;
+
+namespace ariel
+{
+    /*
+     * @brief A 128-bit signed integer, wide enough for any sum of two products of 64-bit and 32-bit numbers.
+    */
+    __extension__ typedef __int128 wide_t;
+
+    /*
+     * @brief Calculates the greatest common divisor of two 128-bit numbers.
+     * @param a The first number.
+     * @param b The second number.
+     * @return wide_t The (non-negative) greatest common divisor of the two numbers.
+     * @note std::gcd doesn't accept __int128 in strict standard mode.
+    */
+    static wide_t __wide_gcd(wide_t a, wide_t b) {
+        a = (a < 0) ? -a : a;
+        b = (b < 0) ? -b : b;
+
+        while (b != 0)
+        {
+            wide_t t = a % b;
+            a = b;
+            b = t;
+        }
+
+        return a;
+    }
+
+    Fraction fma(const Fraction& a, const Fraction& b, const Fraction& c) {
+        // Cross-cancel the product, a and b are already reduced so the product is too.
+        long long g1 = gcd(a.numerator(), b.denominator());
+        long long g2 = gcd(b.numerator(), a.denominator());
+
+        long long product_numerator = static_cast<long long>(a.numerator() / g1) * (b.numerator() / g2);
+        long long product_denominator = static_cast<long long>(a.denominator() / g2) * (b.denominator() / g1);
+
+        // Add c over the LCM of the denominators.
+        long long g = gcd(product_denominator, static_cast<long long>(c.denominator()));
+
+        wide_t numerator = static_cast<wide_t>(product_numerator) * (c.denominator() / g) + static_cast<wide_t>(c.numerator()) * (product_denominator / g);
+        wide_t denominator = static_cast<wide_t>(product_denominator / g) * c.denominator();
+
+        wide_t reduce = __wide_gcd(numerator, denominator);
+        numerator /= reduce;
+        denominator /= reduce;
+
+        if (numerator < numeric_limits<int>::min() || numerator > numeric_limits<int>::max() || denominator > numeric_limits<int>::max())
+        {
+            FRACTION_COUNT(overflows);
+            FRACTION_COUNT(exceptions);
+            throw overflow_error("Fused multiply-add result doesn't fit in a fraction");
+        }
+
+        return Fraction(static_cast<int>(numerator), static_cast<int>(denominator));
+    }
+
+    /*
+     * @brief Divides two integers, rounding the quotient down.
+     * @param numerator The dividend.
+     * @param denominator The divisor (positive).
+     * @return long long The floored quotient.
+     * @note The quotient and the remainder come from the same division instruction.
+    */
+    static inline long long __floor_div(long long numerator, long long denominator) noexcept {
+        long long quotient = numerator / denominator;
+        return (numerator % denominator < 0) ? quotient - 1 : quotient;
+    }
+
+    int floor(const Fraction& fraction) noexcept {
+        return static_cast<int>(__floor_div(fraction.numerator(), fraction.denominator()));
+    }
+
+    int ceil(const Fraction& fraction) noexcept {
+        return static_cast<int>(-__floor_div(-static_cast<long long>(fraction.numerator()), fraction.denominator()));
+    }
+
+    int trunc(const Fraction& fraction) noexcept {
+        return fraction.numerator() / fraction.denominator();
+    }
+
+    int round(const Fraction& fraction, Rounding mode) noexcept {
+        long long denominator = fraction.denominator();
+        long long quotient = __floor_div(fraction.numerator(), denominator);
+        long long twice_remainder = 2 * (fraction.numerator() - quotient * denominator);
+
+        if (twice_remainder > denominator)
+            quotient++;
+
+        else if (twice_remainder == denominator)
+        {
+            // Halfway between quotient and quotient + 1.
+            if (mode == Rounding::HalfEven)
+                quotient += quotient & 1;
+
+            else
+                quotient += (quotient >= 0) ? 1 : 0;
+        }
+
+        return static_cast<int>(quotient);
+    }
+
+    Fraction frac(const Fraction& fraction) noexcept {
+        long long denominator = fraction.denominator();
+        long long remainder = fraction.numerator() - __floor_div(fraction.numerator(), denominator) * denominator;
+
+        return Fraction::__unchecked(static_cast<int>(remainder), fraction.denominator());
+    }
+
+    FractionDivmod divmod(const Fraction& a, const Fraction& b) {
+        if (b.numerator() == 0)
+        {
+            FRACTION_COUNT(exceptions);
+            throw invalid_argument("Can't divide by zero");
+        }
+
+        // Over the common denominator a.denominator() * b.denominator(), a / b is dividend / divisor.
+        long long dividend = static_cast<long long>(a.numerator()) * b.denominator();
+        long long divisor = static_cast<long long>(b.numerator()) * a.denominator();
+        long long denominator = static_cast<long long>(a.denominator()) * b.denominator();
+
+        long long quotient = dividend / divisor;
+        long long remainder = dividend % divisor;
+
+        // Floor the truncated quotient, the remainder then takes the sign of the divisor.
+        if (remainder != 0 && (remainder < 0) != (divisor < 0))
+        {
+            quotient--;
+            remainder += divisor;
+        }
+
+        long long reduce = gcd(remainder, denominator);
+        remainder /= reduce;
+        denominator /= reduce;
+
+        if (remainder < numeric_limits<int>::min() || remainder > numeric_limits<int>::max() || denominator > numeric_limits<int>::max())
+        {
+            FRACTION_COUNT(overflows);
+            FRACTION_COUNT(exceptions);
+            throw overflow_error("Remainder doesn't fit in a fraction");
+        }
+
+        return {quotient, Fraction(static_cast<int>(remainder), static_cast<int>(denominator))};
+    }
+
+    Fraction operator%(const Fraction& a, const Fraction& b) {
+        return divmod(a, b).remainder;
+    }
+
+    /*
+     * @brief Raises an integer to a power by squaring.
+     * @param base The number to raise.
+     * @param exponent The power.
+     * @param out The number base^exponent.
+     * @return True if the power overflowed an int, false otherwise.
+     * @note The base is only squared while a higher bit of the exponent is left, so the squares never overflow unless the power does.
+    */
+    static bool __power(int base, unsigned int exponent, int& out) noexcept {
+        int result = 1;
+
+        while (true)
+        {
+            if ((exponent & 1) != 0 && overflow::mul(result, base, result))
+                return true;
+
+            exponent >>= 1;
+
+            if (exponent == 0)
+                break;
+
+            if (overflow::mul(base, base, base))
+                return true;
+        }
+
+        out = result;
+        return false;
+    }
+
+    Fraction pow(const Fraction& base, int exponent) {
+        long long numerator = base.numerator(), denominator = base.denominator();
+
+        if (exponent < 0)
+        {
+            if (numerator == 0)
+            {
+                FRACTION_COUNT(exceptions);
+                throw invalid_argument("Can't raise zero to a negative power");
+            }
+
+            // The reciprocal, with the sign moved to the numerator.
+            swap(numerator, denominator);
+
+            if (denominator < 0)
+            {
+                numerator = -numerator;
+                denominator = -denominator;
+            }
+        }
+
+        unsigned int magnitude = (exponent < 0) ? 0u - static_cast<unsigned int>(exponent) : static_cast<unsigned int>(exponent);
+        int result_numerator, result_denominator;
+
+        if (!overflow::fits_int(numerator) || !overflow::fits_int(denominator) ||
+            __power(static_cast<int>(numerator), magnitude, result_numerator) || __power(static_cast<int>(denominator), magnitude, result_denominator))
+        {
+            FRACTION_COUNT(overflows);
+            FRACTION_COUNT(exceptions);
+            throw overflow_error("Power doesn't fit in a fraction");
+        }
+
+        return Fraction::__unchecked(result_numerator, result_denominator);
+    }
+
+    /*
+     * @brief Returns the modular inverse of a number.
+     * @param value The number to invert, in [0, modulus).
+     * @param modulus The modulus (positive).
+     * @return long long The inverse of the number, in [0, modulus).
+     * @throw invalid_argument if the number isn't coprime with the modulus.
+    */
+    static long long __inverse(long long value, long long modulus) {
+        // Extended Euclid, keeping only the coefficients of value.
+        wide_t r0 = modulus, r1 = value, t0 = 0, t1 = 1;
+
+        while (r1 != 0)
+        {
+            wide_t quotient = r0 / r1;
+            wide_t r = r0 - quotient * r1, t = t0 - quotient * t1;
+            r0 = r1;
+            r1 = r;
+            t0 = t1;
+            t1 = t;
+        }
+
+        if (r0 != 1)
+        {
+            FRACTION_COUNT(exceptions);
+            throw invalid_argument("Value isn't invertible modulo the modulus");
+        }
+
+        return static_cast<long long>((t0 < 0) ? t0 + modulus : t0);
+    }
+
+    /*
+     * @brief Reduces a number modulo a modulus.
+     * @return long long The residue of the number, in [0, modulus).
+    */
+    static inline long long __residue(long long value, long long modulus) noexcept {
+        long long residue = value % modulus;
+        return (residue < 0) ? residue + modulus : residue;
+    }
+
+    long long pow_mod(const Fraction& base, long long exponent, long long modulus) {
+        if (modulus <= 0)
+        {
+            FRACTION_COUNT(exceptions);
+            throw invalid_argument("Modulus must be positive");
+        }
+
+        long long value = static_cast<long long>((static_cast<wide_t>(__residue(base.numerator(), modulus)) *
+                                                  __inverse(__residue(base.denominator(), modulus), modulus)) % modulus);
+
+        if (exponent < 0)
+            value = __inverse(value, modulus);
+
+        unsigned long long magnitude = (exponent < 0) ? 0ull - static_cast<unsigned long long>(exponent) : static_cast<unsigned long long>(exponent);
+        long long result = 1 % modulus;
+
+        for (; magnitude != 0; magnitude >>= 1)
+        {
+            if ((magnitude & 1) != 0)
+                result = static_cast<long long>((static_cast<wide_t>(result) * value) % modulus);
+
+            value = static_cast<long long>((static_cast<wide_t>(value) * value) % modulus);
+        }
+
+        return result;
+    }
+}
@@ -0,0 +1,144 @@
+/*
+ *  Software Systems CPP Course Assignment 3
+ *  Copyright (C) 2023  Roy Simanovich
+ * 
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ * 
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <https://www.gnu.org/licenses/>.
+*/
+
+#ifndef _FRACTIONMATH_HPP
+#define _FRACTIONMATH_HPP
+
+#include "Fraction.hpp"
+
+namespace ariel
+{
+    /*
+     * @brief Fused multiply-add, calculates a * b + c.
+     * @param a The first factor.
+     * @param b The second factor.
+     * @param c The addend.
+     * @return Fraction The reduced result of a * b + c.
+     * @throw overflow_error if the reduced result doesn't fit in a Fraction.
+     * @note The product is cross-cancelled and the sum is calculated over 128-bit intermediates, with a single final reduction.
+    */
+    Fraction fma(const Fraction& a, const Fraction& b, const Fraction& c);
+
+    /*
+     * @brief The tie-breaking rules of round().
+    */
+    enum class Rounding
+    {
+        HalfEven,   // Ties go to the even integer (banker's rounding), e.g. 5/2 rounds to 2.
+        HalfAway    // Ties go away from zero, like std::round, e.g. 5/2 rounds to 3 and -5/2 to -3.
+    };
+
+    /*
+     * @brief The result of divmod(), a floored quotient and its remainder.
+    */
+    struct FractionDivmod
+    {
+        /*
+         * @brief The largest integer q with q * b <= a (for a positive b).
+        */
+        long long quotient;
+
+        /*
+         * @brief The remainder a - quotient * b, it has the sign of b (or is 0).
+        */
+        Fraction remainder;
+    };
+
+    /*
+     * @brief Rounds a fraction down.
+     * @param fraction The fraction to round.
+     * @return int The largest integer not greater than the fraction.
+     * @note A single integer division, corrected by one for negative fractions with a remainder.
+    */
+    int floor(const Fraction& fraction) noexcept;
+
+    /*
+     * @brief Rounds a fraction up.
+     * @param fraction The fraction to round.
+     * @return int The smallest integer not less than the fraction.
+    */
+    int ceil(const Fraction& fraction) noexcept;
+
+    /*
+     * @brief Rounds a fraction towards zero.
+     * @param fraction The fraction to round.
+     * @return int The integer part of the fraction.
+    */
+    int trunc(const Fraction& fraction) noexcept;
+
+    /*
+     * @brief Rounds a fraction to the nearest integer.
+     * @param fraction The fraction to round.
+     * @param mode How to break ties (Rounding::HalfAway, like std::round, by default).
+     * @return int The nearest integer to the fraction.
+     * @note Ties are found exactly by comparing twice the remainder with the denominator.
+    */
+    int round(const Fraction& fraction, Rounding mode = Rounding::HalfAway) noexcept;
+
+    /*
+     * @brief Returns the fractional part of a fraction.
+     * @param fraction The fraction.
+     * @return Fraction The fraction minus its floor, in [0, 1).
+     * @note The remainder of the numerator keeps the gcd with the denominator, so the result needs no reduction.
+    */
+    Fraction frac(const Fraction& fraction) noexcept;
+
+    /*
+     * @brief Floored division of two fractions, like Python's divmod.
+     * @param a The dividend.
+     * @param b The divisor.
+     * @return FractionDivmod The quotient floor(a / b) and the remainder a - quotient * b.
+     * @throw invalid_argument if b is zero.
+     * @throw overflow_error if the remainder doesn't fit in a Fraction.
+     * @note Both fractions are taken over the common denominator a.denominator() * b.denominator(), so the quotient is one 64-bit division of the numerators.
+    */
+    FractionDivmod divmod(const Fraction& a, const Fraction& b);
+
+    /*
+     * @brief Returns the remainder of the floored division of two fractions.
+     * @param a The dividend.
+     * @param b The divisor.
+     * @return Fraction The remainder of divmod(a, b), it has the sign of b (or is 0).
+     * @throw invalid_argument if b is zero.
+     * @throw overflow_error if the remainder doesn't fit in a Fraction.
+    */
+    Fraction operator%(const Fraction& a, const Fraction& b);
+
+    /*
+     * @brief Raises a fraction to an integer power.
+     * @param base The fraction to raise.
+     * @param exponent The power, a negative power raises the reciprocal.
+     * @return Fraction The fraction base^exponent (1 for any base to the power of 0).
+     * @throw invalid_argument if the base is zero and the exponent is negative.
+     * @throw overflow_error if the result doesn't fit in a Fraction.
+     * @note Powers of coprime numbers are coprime, so the members are raised separately by squaring and never reduced.
+    */
+    Fraction pow(const Fraction& base, int exponent);
+
+    /*
+     * @brief Raises a fraction to an integer power in modular arithmetic.
+     * @param base The fraction to raise, taken as numerator * denominator^-1 modulo the modulus.
+     * @param exponent The power, a negative power raises the modular inverse.
+     * @param modulus The modulus.
+     * @return long long The residue of base^exponent, in [0, modulus).
+     * @throw invalid_argument if the modulus isn't positive, or a value that has to be inverted isn't coprime with the modulus.
+     * @note The products are taken over 128 bits, so any modulus up to LLONG_MAX works.
+    */
+    long long pow_mod(const Fraction& base, long long exponent, long long modulus);
+}
+
+#endif
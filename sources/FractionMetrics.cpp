@@ -0,0 +1,222 @@
+/*
+ *  Software Systems CPP Course Assignment 3
+ *  Copyright (C) 2023  Roy Simanovich
+ * 
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ * 
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <https://www.gnu.org/licenses/>.
+*/
+
+#include <atomic>
+#include <bit>
+#include <cstdio>
+#include <fstream>
+#include "FractionMetrics.hpp"
+
+using namespace std;
+
+namespace ariel
+{
+    namespace metrics
+    {
+        /*
+         * @brief The Prometheus label values of the families.
+        */
+        static const char* const FAMILY_NAMES[FAMILIES] = {"construct", "add", "mul", "div", "compare", "parse", "format"};
+
+        /*
+         * @brief A latency histogram of a single family.
+        */
+        struct Histogram
+        {
+            atomic<uint64_t> buckets[BUCKETS];
+            atomic<uint64_t> sum;
+            atomic<uint64_t> count;
+        };
+
+        /*
+         * @brief The histograms, one per family (zero initialized, as static storage).
+        */
+        static Histogram __histograms[FAMILIES];
+
+        /*
+         * @brief The sample interval shared by all the threads.
+        */
+        static atomic<unsigned int> __interval(64);
+
+        /*
+         * @brief The operations of every family the calling thread still has to skip before its next sample.
+         * @note One per family, so interleaved families (e.g. a+b then a<b) are each sampled at the interval.
+        */
+        static thread_local unsigned int __countdown[FAMILIES] = {};
+
+        /*
+         * @brief True while the calling thread is inside a timed operation.
+        */
+        static thread_local bool __timing = false;
+
+        bool enabled() {
+#ifdef FRACTION_METRICS
+            return true;
+#else
+            return false;
+#endif
+        }
+
+        void set_sample_interval(unsigned int interval) {
+            __interval.store(interval, memory_order_relaxed);
+        }
+
+        unsigned int sample_interval() {
+            return __interval.load(memory_order_relaxed);
+        }
+
+        unsigned int bucket(uint64_t nanoseconds) {
+            if (nanoseconds < SUB_BUCKETS)
+                return static_cast<unsigned int>(nanoseconds);
+
+            // The power of two selects the bucket group, the next two bits select the sub-bucket.
+            unsigned int exponent = static_cast<unsigned int>(bit_width(nanoseconds)) - 1;
+            unsigned int sub = static_cast<unsigned int>(nanoseconds >> (exponent - 2)) & (SUB_BUCKETS - 1);
+            unsigned int index = SUB_BUCKETS + (exponent - 2) * SUB_BUCKETS + sub;
+
+            return (index < BUCKETS) ? index : BUCKETS - 1;
+        }
+
+        uint64_t bucket_limit(unsigned int index) {
+            if (index < SUB_BUCKETS)
+                return index;
+
+            unsigned int exponent = (index - SUB_BUCKETS) / SUB_BUCKETS + 2;
+            uint64_t sub = (index - SUB_BUCKETS) % SUB_BUCKETS;
+
+            return ((SUB_BUCKETS + sub + 1) << (exponent - 2)) - 1;
+        }
+
+        void record(Family family, uint64_t nanoseconds) noexcept {
+            Histogram& histogram = __histograms[family];
+
+            histogram.buckets[bucket(nanoseconds)].fetch_add(1, memory_order_relaxed);
+            histogram.sum.fetch_add(nanoseconds, memory_order_relaxed);
+            histogram.count.fetch_add(1, memory_order_relaxed);
+        }
+
+        uint64_t count(Family family) {
+            return __histograms[family].count.load(memory_order_relaxed);
+        }
+
+        void reset() {
+            for (Histogram& histogram : __histograms)
+            {
+                for (auto& value : histogram.buckets)
+                    value.store(0, memory_order_relaxed);
+
+                histogram.sum.store(0, memory_order_relaxed);
+                histogram.count.store(0, memory_order_relaxed);
+            }
+        }
+
+        void dump_prometheus(ostream& os) {
+            // Every family gets the same bucket bounds, up to the highest bucket any family used.
+            unsigned int last = 0;
+
+            for (const Histogram& histogram : __histograms)
+                for (unsigned int i = 0; i < BUCKETS; i++)
+                    if (histogram.buckets[i].load(memory_order_relaxed) != 0 && i > last)
+                        last = i;
+
+            // The bounds are below 2^41 ns, so 13 significant digits keep them exact.
+            ios::fmtflags flags = os.flags();
+            streamsize precision = os.precision();
+            os.unsetf(ios::floatfield);
+            os.precision(13);
+
+            os << "# HELP fraction_operation_latency_seconds Sampled latency of Fraction operations.\n";
+            os << "# TYPE fraction_operation_latency_seconds histogram\n";
+
+            for (unsigned int family = 0; family < FAMILIES; family++)
+            {
+                const Histogram& histogram = __histograms[family];
+                uint64_t cumulative = 0;
+
+                // The last bucket has no finite bound, the +Inf line below covers it.
+                for (unsigned int i = 0; i <= last && i < BUCKETS - 1; i++)
+                {
+                    cumulative += histogram.buckets[i].load(memory_order_relaxed);
+                    os << "fraction_operation_latency_seconds_bucket{op=\"" << FAMILY_NAMES[family] << "\",le=\""
+                       << static_cast<double>(bucket_limit(i)) * 1e-9 << "\"} " << cumulative << "\n";
+                }
+
+                os << "fraction_operation_latency_seconds_bucket{op=\"" << FAMILY_NAMES[family] << "\",le=\"+Inf\"} "
+                   << histogram.count.load(memory_order_relaxed) << "\n";
+                os << "fraction_operation_latency_seconds_sum{op=\"" << FAMILY_NAMES[family] << "\"} "
+                   << static_cast<double>(histogram.sum.load(memory_order_relaxed)) * 1e-9 << "\n";
+                os << "fraction_operation_latency_seconds_count{op=\"" << FAMILY_NAMES[family] << "\"} "
+                   << histogram.count.load(memory_order_relaxed) << "\n";
+            }
+
+            os.flags(flags);
+            os.precision(precision);
+        }
+
+        bool dump_prometheus(const string& path) {
+            string temporary = path + ".tmp";
+
+            {
+                ofstream file(temporary);
+
+                if (!file)
+                    return false;
+
+                dump_prometheus(file);
+
+                if (!file)
+                    return false;
+            }
+
+            return rename(temporary.c_str(), path.c_str()) == 0;
+        }
+
+        ScopedTimer::ScopedTimer(Family family) noexcept: _family(family), _sampled(false) {
+            unsigned int interval = __interval.load(memory_order_relaxed);
+
+            // Nested timers neither sample nor count, so they don't shift the countdown of their family.
+            if (interval == 0 || __timing)
+                return;
+
+            unsigned int& countdown = __countdown[family];
+
+            // A countdown left over from a larger interval is cut down, so a new interval applies right away.
+            if (countdown >= interval)
+                countdown = interval - 1;
+
+            if (countdown > 0)
+            {
+                countdown--;
+                return;
+            }
+
+            countdown = interval - 1;
+            __timing = true;
+            _sampled = true;
+            _start = chrono::steady_clock::now();
+        }
+
+        ScopedTimer::~ScopedTimer() {
+            if (!_sampled)
+                return;
+
+            auto elapsed = chrono::duration_cast<chrono::nanoseconds>(chrono::steady_clock::now() - _start).count();
+            record(_family, static_cast<uint64_t>(elapsed));
+            __timing = false;
+        }
+    }
+}
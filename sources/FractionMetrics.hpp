@@ -0,0 +1,162 @@
+/*
+ *  Software Systems CPP Course Assignment 3
+ *  Copyright (C) 2023  Roy Simanovich
+ * 
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ * 
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <https://www.gnu.org/licenses/>.
+*/
+
+#ifndef _FRACTIONMETRICS_HPP
+#define _FRACTIONMETRICS_HPP
+
+#include <chrono>
+#include <cstdint>
+#include <iostream>
+#include <string>
+
+/*
+ * Sampled per-operation latency histograms of the library.
+ *
+ * Compile with -DFRACTION_METRICS (make METRICS=1) to time one in every sample_interval() operations
+ * of every family and record it in a log-bucketed (HDR style) histogram.
+ * Without it, FRACTION_LATENCY() expands to nothing and the histograms stay empty.
+*/
+
+namespace ariel
+{
+    namespace metrics
+    {
+        /*
+         * @brief The operation families that are timed.
+        */
+        enum Family
+        {
+            construct,  // Fraction(int, int) and Fraction(float).
+            add,        // Addition and subtraction, including the compound and increment operators.
+            mul,        // Multiplication.
+            div,        // Division.
+            compare,    // Comparison operators.
+            parse,      // operator>>.
+            format,     // operator<<.
+            FAMILIES
+        };
+
+        /*
+         * @brief The number of sub-buckets per power of two (2 bits of precision, at most 25% relative error).
+        */
+        const unsigned int SUB_BUCKETS = 4;
+
+        /*
+         * @brief The number of buckets of every histogram, covering 0 ns to about 36 minutes (2^41 ns); longer latencies are clamped into the last one.
+        */
+        const unsigned int BUCKETS = SUB_BUCKETS * 40;
+
+        /*
+         * @brief Checks whether the library was compiled with latency metrics.
+         * @return True if the operations are timed, false otherwise.
+        */
+        bool enabled();
+
+        /*
+         * @brief Sets how often operations are timed.
+         * @param interval Time one in every interval operations of a thread (1 times all of them, 0 turns timing off).
+         * @note The default interval is 64.
+        */
+        void set_sample_interval(unsigned int interval);
+
+        /*
+         * @brief Returns how often operations are timed.
+         * @return unsigned int The sample interval.
+        */
+        unsigned int sample_interval();
+
+        /*
+         * @brief Returns the histogram bucket of a latency.
+         * @param nanoseconds The latency.
+         * @return unsigned int The index of the bucket.
+        */
+        unsigned int bucket(std::uint64_t nanoseconds);
+
+        /*
+         * @brief Returns the largest latency of a histogram bucket.
+         * @param index The index of the bucket.
+         * @return std::uint64_t The largest latency (in nanoseconds) that falls in the bucket.
+        */
+        std::uint64_t bucket_limit(unsigned int index);
+
+        /*
+         * @brief Records a latency in the histogram of a family.
+         * @param family The operation family.
+         * @param nanoseconds The latency.
+        */
+        void record(Family family, std::uint64_t nanoseconds) noexcept;
+
+        /*
+         * @brief Returns the number of latencies recorded for a family.
+         * @param family The operation family.
+         * @return std::uint64_t The number of recorded latencies.
+        */
+        std::uint64_t count(Family family);
+
+        /*
+         * @brief Clears all the histograms.
+        */
+        void reset();
+
+        /*
+         * @brief Writes all the histograms in the Prometheus text exposition format.
+         * @param os The output stream.
+         * @note The metric is fraction_operation_latency_seconds, a histogram with an "op" label per family.
+         * @note The bounds are written with enough digits to be exact to the nanosecond, whatever the format of the stream (which is restored after).
+         * @note The last bucket also holds the clamped latencies, so it is only reported as le="+Inf".
+        */
+        void dump_prometheus(std::ostream& os);
+
+        /*
+         * @brief Writes all the histograms in the Prometheus text exposition format to a file.
+         * @param path The path of the file (replaced atomically, so a scraper never reads a partial file).
+         * @return True if the file was written, false otherwise.
+        */
+        bool dump_prometheus(const std::string& path);
+
+        /*
+         * @brief Times the enclosing scope if the calling thread's sample counter is due.
+         * @note Nested timers (e.g. the Fraction operation inside a float operator) are skipped, so every sample is a single top-level operation.
+        */
+        class ScopedTimer
+        {
+            private:
+                Family _family;
+                bool _sampled;
+                std::chrono::steady_clock::time_point _start;
+
+            public:
+                explicit ScopedTimer(Family family) noexcept;
+                ~ScopedTimer();
+
+                ScopedTimer(const ScopedTimer& other) = delete;
+                ScopedTimer& operator=(const ScopedTimer& other) = delete;
+        };
+    }
+}
+
+#ifdef FRACTION_METRICS
+/*
+ * @brief Times the rest of the enclosing scope as an operation of the given family.
+ * @param family The name of the family (a member of metrics::Family).
+*/
+#define FRACTION_LATENCY(family) ::ariel::metrics::ScopedTimer __fraction_latency_timer(::ariel::metrics::family)
+#else
+#define FRACTION_LATENCY(family) ((void)0)
+#endif
+
+#endif
@@ -0,0 +1,114 @@
+/*
+ *  Software Systems CPP Course Assignment 3
+ *  Copyright (C) 2023  Roy Simanovich
+ * 
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ * 
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <https://www.gnu.org/licenses/>.
+*/
+
+#include <algorithm>
+#include <numeric>
+#include <stdexcept>
+#include <vector>
+#include "FractionParallel.hpp"
+#include "FractionAccumulator.hpp"
+#include "FractionChunks.hpp"
+#include "Overflow.hpp"
+#include "FractionStats.hpp"
+
+using namespace std;
+
+namespace ariel
+{
+    /*
+     * @brief Multiplies two fractions with cross-cancellation and wide intermediates.
+     * @param a The first fraction.
+     * @param b The second fraction.
+     * @return Fraction The reduced product.
+     * @throw overflow_error if the product doesn't fit in a Fraction.
+    */
+    static Fraction __multiply(const Fraction& a, const Fraction& b) {
+        long long g1 = gcd(a.numerator(), b.denominator());
+        long long g2 = gcd(b.numerator(), a.denominator());
+
+        long long numerator = (a.numerator() / g1) * (b.numerator() / g2);
+        long long denominator = (a.denominator() / g2) * (b.denominator() / g1);
+
+        if (!overflow::fits_int(numerator) || !overflow::fits_int(denominator))
+        {
+            FRACTION_COUNT(overflows);
+            FRACTION_COUNT(exceptions);
+            throw overflow_error("Product doesn't fit in a fraction");
+        }
+
+        return Fraction(static_cast<int>(numerator), static_cast<int>(denominator));
+    }
+
+    /*
+     * @brief Multiplies a range of fractions in a balanced tree.
+     * @param values The fractions to multiply.
+     * @return Fraction The reduced product (1/1 for an empty range).
+    */
+    static Fraction __tree_product(span<const Fraction> values) {
+        if (values.empty())
+            return Fraction(1, 1);
+
+        if (values.size() == 1)
+            return values[0];
+
+        size_t half = values.size() / 2;
+
+        return __multiply(__tree_product(values.first(half)), __tree_product(values.subspan(half)));
+    }
+
+    /*
+     * @brief Merges partial accumulators in a balanced tree.
+     * @param partials The partial accumulators (merged in place).
+     * @param first The first partial to merge.
+     * @param last One past the last partial to merge.
+     * @return FractionAccumulator& The accumulator holding the merged sum.
+    */
+    static FractionAccumulator& __tree_merge(vector<FractionAccumulator>& partials, size_t first, size_t last) {
+        if (last - first == 1)
+            return partials[first];
+
+        size_t middle = first + (last - first) / 2;
+
+        FractionAccumulator& left = __tree_merge(partials, first, middle);
+        left.merge(__tree_merge(partials, middle, last));
+
+        return left;
+    }
+
+    Fraction parallel_sum(span<const Fraction> values, unsigned int threads) {
+        size_t chunks = __chunks(values.size(), threads);
+        vector<FractionAccumulator> partials(chunks);
+
+        __for_each_chunk(values.size(), chunks, [&](size_t index, size_t first, size_t last) {
+            for (const Fraction& fraction : values.subspan(first, last - first))
+                partials[index].add(fraction);
+        });
+
+        return __tree_merge(partials, 0, chunks).result();
+    }
+
+    Fraction parallel_product(span<const Fraction> values, unsigned int threads) {
+        size_t chunks = __chunks(values.size(), threads);
+        vector<Fraction> partials(chunks);
+
+        __for_each_chunk(values.size(), chunks, [&](size_t index, size_t first, size_t last) {
+            partials[index] = __tree_product(values.subspan(first, last - first));
+        });
+
+        return __tree_product(partials);
+    }
+}
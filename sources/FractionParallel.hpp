@@ -0,0 +1,49 @@
+/*
+ *  Software Systems CPP Course Assignment 3
+ *  Copyright (C) 2023  Roy Simanovich
+ * 
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ * 
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <https://www.gnu.org/licenses/>.
+*/
+
+#ifndef _FRACTIONPARALLEL_HPP
+#define _FRACTIONPARALLEL_HPP
+
+#include <span>
+#include "Fraction.hpp"
+
+namespace ariel
+{
+    /*
+     * @brief Sums a range of fractions using several threads.
+     * @param values The fractions to sum.
+     * @param threads The number of chunks to split the range into (0 means one per thread of the default thread pool, plus the caller).
+     * @return Fraction The exact, reduced sum of the fractions.
+     * @throw overflow_error if the sum doesn't fit in a Fraction.
+     * @note Every thread sums its chunk with a FractionAccumulator, and the partial sums are merged in a balanced tree.
+     * @note The result is exact, so it is the same as the serial fold on every run, for any number of threads.
+    */
+    Fraction parallel_sum(std::span<const Fraction> values, unsigned int threads = 0);
+
+    /*
+     * @brief Multiplies a range of fractions using several threads.
+     * @param values The fractions to multiply.
+     * @param threads The number of chunks to split the range into (0 means one per thread of the default thread pool, plus the caller).
+     * @return Fraction The exact, reduced product of the fractions (1/1 for an empty range).
+     * @throw overflow_error if an intermediate product doesn't fit in a Fraction.
+     * @note Every chunk is multiplied in a balanced tree, and so are the partial products, which keeps the intermediates small.
+     * @note The result is exact, so it is the same as the serial fold on every run, for any number of threads.
+    */
+    Fraction parallel_product(std::span<const Fraction> values, unsigned int threads = 0);
+}
+
+#endif
@@ -0,0 +1,70 @@
+/*
+ *  Software Systems CPP Course Assignment 3
+ *  Copyright (C) 2023  Roy Simanovich
+ * 
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ * 
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <https://www.gnu.org/licenses/>.
+*/
+
+#ifndef _FRACTIONPROBES_HPP
+#define _FRACTIONPROBES_HPP
+
+/*
+ * Static (USDT) tracepoints of the library, under the "fraction" provider.
+ *
+ * When <sys/sdt.h> is available (systemtap-sdt-dev on Debian and Ubuntu), every probe is a single nop
+ * plus an ELF note, so perf and bpftrace can attach to a live process at no cost while nobody traces.
+ * Compile with -DFRACTION_NO_PROBES (make PROBES=0), or without <sys/sdt.h>, and the probes expand to nothing.
+ *
+ * The probes and their arguments:
+ *   reduce__entry(numerator, denominator), reduce__return(numerator, denominator)    Fraction::__reduce
+ *   float__entry(), float__return(numerator, denominator)                             Fraction(float)
+ *   parse__entry(), parse__return(numerator, denominator)                             operator>>
+ *   format__entry(numerator, denominator), format__return()                           operator<<
+ *
+ * An operation that exits by an exception fires no return probe.
+*/
+
+#if !defined(FRACTION_NO_PROBES) && defined(__has_include)
+#if __has_include(<sys/sdt.h>)
+#include <sys/sdt.h>
+#define FRACTION_HAS_PROBES
+#endif
+#endif
+
+namespace ariel
+{
+    namespace probes
+    {
+        /*
+         * @brief Checks whether the library was compiled with static tracepoints.
+         * @return True if the probes are in the binary, false otherwise.
+        */
+        constexpr bool enabled() {
+#ifdef FRACTION_HAS_PROBES
+            return true;
+#else
+            return false;
+#endif
+        }
+    }
+}
+
+#ifdef FRACTION_HAS_PROBES
+#define FRACTION_PROBE(name) DTRACE_PROBE(fraction, name)
+#define FRACTION_PROBE2(name, a, b) DTRACE_PROBE2(fraction, name, a, b)
+#else
+#define FRACTION_PROBE(name) ((void)0)
+#define FRACTION_PROBE2(name, a, b) ((void)0)
+#endif
+
+#endif
@@ -0,0 +1,153 @@
+/*
+ *  Software Systems CPP Course Assignment 3
+ *  Copyright (C) 2023  Roy Simanovich
+ * 
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ * 
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <https://www.gnu.org/licenses/>.
+*/
+
+#include <algorithm>
+#include <mutex>
+#include <vector>
+#include "FractionStats.hpp"
+
+using namespace std;
+
+namespace ariel
+{
+    namespace stats
+    {
+#ifdef FRACTION_INSTRUMENTATION
+        /*
+         * @brief The counters of a single thread.
+         * @note Registers itself in the registry so snapshot_all() can read it, and folds its counts into the retired totals when the thread exits.
+        */
+        struct ThreadCounters
+        {
+            atomic<uint64_t> values[COUNTERS];
+
+            ThreadCounters();
+            ~ThreadCounters();
+        };
+
+        /*
+         * @brief The registry of the live threads' counters and the totals of the exited threads.
+        */
+        struct Registry
+        {
+            mutex lock;
+            vector<ThreadCounters*> threads;
+            uint64_t retired[COUNTERS] = {};
+        };
+
+        static Registry& __registry() {
+            static Registry registry;
+            return registry;
+        }
+
+        ThreadCounters::ThreadCounters() {
+            for (auto& value : values)
+                value.store(0, memory_order_relaxed);
+
+            Registry& registry = __registry();
+            lock_guard<mutex> guard(registry.lock);
+            registry.threads.push_back(this);
+        }
+
+        ThreadCounters::~ThreadCounters() {
+            Registry& registry = __registry();
+            lock_guard<mutex> guard(registry.lock);
+
+            for (size_t i = 0; i < COUNTERS; i++)
+                registry.retired[i] += values[i].load(memory_order_relaxed);
+
+            registry.threads.erase(find(registry.threads.begin(), registry.threads.end(), this));
+        }
+
+        atomic<uint64_t>* local() noexcept {
+            static thread_local ThreadCounters counters;
+            return counters.values;
+        }
+
+        /*
+         * @brief Converts a counter array to a snapshot.
+         * @param values The counter array, indexed by Counter.
+         * @return FractionCounters The snapshot.
+        */
+        template <typename T>
+        static FractionCounters __snapshot(const T* values) {
+            FractionCounters snapshot;
+            uint64_t FractionCounters::* members[COUNTERS] = {
+                &FractionCounters::constructions, &FractionCounters::reductions, &FractionCounters::gcd_iterations,
+                &FractionCounters::float_conversions, &FractionCounters::float_iterations, &FractionCounters::exceptions,
+                &FractionCounters::overflows
+            };
+
+            for (size_t i = 0; i < COUNTERS; i++)
+                snapshot.*members[i] = values[i];
+
+            return snapshot;
+        }
+
+        bool enabled() {
+            return true;
+        }
+
+        FractionCounters snapshot() {
+            uint64_t values[COUNTERS];
+            atomic<uint64_t>* counters = local();
+
+            for (size_t i = 0; i < COUNTERS; i++)
+                values[i] = counters[i].load(memory_order_relaxed);
+
+            return __snapshot(values);
+        }
+
+        FractionCounters snapshot_all() {
+            Registry& registry = __registry();
+            lock_guard<mutex> guard(registry.lock);
+            uint64_t values[COUNTERS];
+
+            for (size_t i = 0; i < COUNTERS; i++)
+            {
+                values[i] = registry.retired[i];
+
+                for (ThreadCounters* thread : registry.threads)
+                    values[i] += thread->values[i].load(memory_order_relaxed);
+            }
+
+            return __snapshot(values);
+        }
+
+        void reset() {
+            atomic<uint64_t>* counters = local();
+
+            for (size_t i = 0; i < COUNTERS; i++)
+                counters[i].store(0, memory_order_relaxed);
+        }
+#else
+        bool enabled() {
+            return false;
+        }
+
+        FractionCounters snapshot() {
+            return FractionCounters();
+        }
+
+        FractionCounters snapshot_all() {
+            return FractionCounters();
+        }
+
+        void reset() {}
+#endif
+    }
+}
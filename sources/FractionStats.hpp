@@ -0,0 +1,119 @@
+/*
+ *  Software Systems CPP Course Assignment 3
+ *  Copyright (C) 2023  Roy Simanovich
+ * 
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ * 
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <https://www.gnu.org/licenses/>.
+*/
+
+#ifndef _FRACTIONSTATS_HPP
+#define _FRACTIONSTATS_HPP
+
+#include <atomic>
+#include <cstdint>
+
+/*
+ * Hot-path instrumentation of the library.
+ *
+ * Compile with -DFRACTION_INSTRUMENTATION (make INSTRUMENT=1) to count constructions, reductions,
+ * GCD iterations, float conversions, exceptions and overflows in thread-local counters.
+ * Without it, FRACTION_COUNT() expands to nothing and the snapshots are always zero.
+*/
+
+namespace ariel
+{
+    /*
+     * @brief A snapshot of the instrumentation counters.
+    */
+    struct FractionCounters
+    {
+        std::uint64_t constructions = 0;        // Fractions constructed from values (int, float or default, not copies).
+        std::uint64_t reductions = 0;           // Calls of __reduce.
+        std::uint64_t gcd_iterations = 0;       // Steps of the Euclidean algorithm in __gcd.
+        std::uint64_t float_conversions = 0;    // Calls of Fraction(float).
+        std::uint64_t float_iterations = 0;     // Decimal loop iterations in Fraction(float).
+        std::uint64_t exceptions = 0;           // Exceptions thrown by the library.
+        std::uint64_t overflows = 0;            // Overflows detected by the checked and wide paths.
+    };
+
+    namespace stats
+    {
+        /*
+         * @brief Checks whether the library was compiled with instrumentation.
+         * @return True if the counters are live, false otherwise.
+        */
+        bool enabled();
+
+        /*
+         * @brief Returns the counters of the calling thread.
+         * @return FractionCounters The counters of the calling thread.
+        */
+        FractionCounters snapshot();
+
+        /*
+         * @brief Returns the sum of the counters of all the threads, including the ones that already exited.
+         * @return FractionCounters The sum of the counters of all the threads.
+         * @note The counters of other threads are read while they may still be counting, so the sum is a lower bound.
+        */
+        FractionCounters snapshot_all();
+
+        /*
+         * @brief Resets the counters of the calling thread.
+        */
+        void reset();
+
+#ifdef FRACTION_INSTRUMENTATION
+        /*
+         * @brief The counters, in the order of the FractionCounters members.
+        */
+        enum Counter
+        {
+            constructions,
+            reductions,
+            gcd_iterations,
+            float_conversions,
+            float_iterations,
+            exceptions,
+            overflows,
+            COUNTERS
+        };
+
+        /*
+         * @brief Returns the counters of the calling thread.
+         * @return std::atomic<std::uint64_t>* The array of the thread's counters, indexed by Counter.
+        */
+        std::atomic<std::uint64_t>* local() noexcept;
+
+        /*
+         * @brief Increments a counter of the calling thread.
+         * @param counter The counter to increment.
+         * @note Only the owning thread writes its counters, so a relaxed load and store (a plain add) is enough, no atomic read-modify-write.
+        */
+        inline void count(Counter counter) noexcept {
+            std::atomic<std::uint64_t>& value = local()[counter];
+            value.store(value.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+        }
+#endif
+    }
+}
+
+#ifdef FRACTION_INSTRUMENTATION
+/*
+ * @brief Increments a counter of the calling thread.
+ * @param counter The name of the counter (a member of FractionCounters).
+*/
+#define FRACTION_COUNT(counter) (::ariel::stats::count(::ariel::stats::counter))
+#else
+#define FRACTION_COUNT(counter) ((void)0)
+#endif
+
+#endif
@@ -0,0 +1,79 @@
+/*
+ *  Software Systems CPP Course Assignment 3
+ *  Copyright (C) 2023  Roy Simanovich
+ * 
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ * 
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <https://www.gnu.org/licenses/>.
+*/
+
+#ifndef _OVERFLOW_HPP
+#define _OVERFLOW_HPP
+
+#include <limits>
+
+namespace ariel
+{
+    /*
+     * @brief Overflow-checked integer helpers for the wide (long long) paths of the library.
+     * @note Every helper stores the (wrapped) result in "out" and returns true if the operation overflowed.
+     * @note Both GCC and Clang lower these builtins to a single instruction plus a flag check.
+    */
+    namespace overflow
+    {
+        /*
+         * @brief Adds two numbers.
+         * @param a The first number.
+         * @param b The second number.
+         * @param out The result of the addition.
+         * @return True if the addition overflowed, false otherwise.
+        */
+        template <typename T>
+        inline bool add(T a, T b, T& out) {
+            return __builtin_add_overflow(a, b, &out);
+        }
+
+        /*
+         * @brief Subtracts two numbers.
+         * @param a The first number.
+         * @param b The second number.
+         * @param out The result of the subtraction.
+         * @return True if the subtraction overflowed, false otherwise.
+        */
+        template <typename T>
+        inline bool sub(T a, T b, T& out) {
+            return __builtin_sub_overflow(a, b, &out);
+        }
+
+        /*
+         * @brief Multiplies two numbers.
+         * @param a The first number.
+         * @param b The second number.
+         * @param out The result of the multiplication.
+         * @return True if the multiplication overflowed, false otherwise.
+        */
+        template <typename T>
+        inline bool mul(T a, T b, T& out) {
+            return __builtin_mul_overflow(a, b, &out);
+        }
+
+        /*
+         * @brief Checks whether a wide number fits in an int.
+         * @param value The number to check.
+         * @return True if the number fits in an int, false otherwise.
+        */
+        inline bool fits_int(long long value) {
+            return value >= std::numeric_limits<int>::min() && value <= std::numeric_limits<int>::max();
+        }
+    }
+}
+
+#endif
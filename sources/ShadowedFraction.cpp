@@ -0,0 +1,79 @@
+/*
+ *  Software Systems CPP Course Assignment 3
+ *  Copyright (C) 2023  Roy Simanovich
+ * 
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ * 
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <https://www.gnu.org/licenses/>.
+*/
+
+#include <cmath>
+#include "ShadowedFraction.hpp"
+
+using namespace std;
+
+namespace ariel
+{
+    /*
+     * @brief The relative error bound of two shadows together (2^-52, twice the rounding error of one).
+    */
+    static const double SHADOW_EPSILON = 0x1p-52;
+
+    /*
+     * @brief Computes the shadow of a fraction.
+    */
+    static double __shadow(const Fraction& value) noexcept {
+        // Both members are ints, so they are exact doubles and the quotient is correctly rounded.
+        return static_cast<double>(value.numerator()) / value.denominator();
+    }
+
+    ShadowedFraction::ShadowedFraction() noexcept: _value(), _shadow(0) {}
+
+    ShadowedFraction::ShadowedFraction(const Fraction& value) noexcept: _value(value), _shadow(__shadow(value)) {}
+
+    ShadowedFraction::ShadowedFraction(int numerator, int denominator): ShadowedFraction(Fraction(numerator, denominator)) {}
+
+    int ShadowedFraction::__compare_exact(const ShadowedFraction& other) const noexcept {
+        long long left = static_cast<long long>(_value.numerator()) * other._value.denominator();
+        long long right = static_cast<long long>(other._value.numerator()) * _value.denominator();
+
+        return (left < right) ? -1 : (left > right) ? 1 : 0;
+    }
+
+    int ShadowedFraction::compare(const ShadowedFraction& other) const noexcept {
+        double difference = _shadow - other._shadow;
+
+        if (fabs(difference) > (fabs(_shadow) + fabs(other._shadow)) * SHADOW_EPSILON)
+            return (difference < 0) ? -1 : 1;
+
+        return __compare_exact(other);
+    }
+
+    ShadowedFraction ShadowedFraction::operator+(const ShadowedFraction& other) const {
+        return ShadowedFraction(_value + other._value);
+    }
+
+    ShadowedFraction ShadowedFraction::operator-(const ShadowedFraction& other) const {
+        return ShadowedFraction(_value - other._value);
+    }
+
+    ShadowedFraction ShadowedFraction::operator*(const ShadowedFraction& other) const {
+        return ShadowedFraction(_value * other._value);
+    }
+
+    ShadowedFraction ShadowedFraction::operator/(const ShadowedFraction& other) const {
+        return ShadowedFraction(_value / other._value);
+    }
+
+    ostream& operator<<(ostream& os, const ShadowedFraction& fraction) {
+        return os << fraction._value;
+    }
+}
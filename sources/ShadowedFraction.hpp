@@ -0,0 +1,124 @@
+/*
+ *  Software Systems CPP Course Assignment 3
+ *  Copyright (C) 2023  Roy Simanovich
+ * 
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ * 
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <https://www.gnu.org/licenses/>.
+*/
+
+#ifndef _SHADOWEDFRACTION_HPP
+#define _SHADOWEDFRACTION_HPP
+
+#include <iostream>
+#include "Fraction.hpp"
+
+namespace ariel
+{
+    /*
+     * @brief An exact fraction with a cached double "shadow" of its value, for data that is compared far more often than it is changed.
+     * @note Ordering compares the shadows, and only falls back to exact integer math when they are too close to tell apart.
+     * @note The shadow is the correctly rounded quotient, so its relative error is at most 2^-53; two shadows further apart than that order exactly like the fractions.
+     * @note Every mutation recomputes the shadow (one division).
+    */
+    class ShadowedFraction
+    {
+        private:
+            /*
+             * @brief The exact value.
+            */
+            Fraction _value;
+
+            /*
+             * @brief The value rounded to the nearest double.
+            */
+            double _shadow;
+
+            /*
+             * @brief Compares the exact values.
+             * @return int -1, 0 or 1 if this fraction is smaller than, equal to or larger than the other one.
+            */
+            int __compare_exact(const ShadowedFraction& other) const noexcept;
+
+        public:
+            /*
+             * @brief Default constructor of the ShadowedFraction class.
+             * @note The default fraction is 0/1.
+            */
+            ShadowedFraction() noexcept;
+
+            /*
+             * @brief Wraps a fraction.
+             * @param value The fraction.
+            */
+            ShadowedFraction(const Fraction& value) noexcept;
+
+            /*
+             * @brief Constructs a fraction from a numerator and a denominator.
+             * @throw invalid_argument if the denominator is 0.
+            */
+            ShadowedFraction(int numerator, int denominator);
+
+            /*
+             * @brief Returns the exact value.
+             * @return const Fraction& The exact value.
+            */
+            const Fraction& value() const noexcept { return _value; }
+
+            /*
+             * @brief Returns the cached double value (free, no division).
+             * @return double The value rounded to the nearest double.
+            */
+            double to_double() const noexcept { return _shadow; }
+
+            operator Fraction() const noexcept { return _value; }
+
+            /*
+             * @brief Compares two fractions.
+             * @param other The fraction to compare with.
+             * @return int -1, 0 or 1 if this fraction is smaller than, equal to or larger than the other one.
+             * @note Decided by the shadows unless they are within their error bound of each other.
+            */
+            int compare(const ShadowedFraction& other) const noexcept;
+
+            /*
+             * @brief Arithmetic operators, computed exactly on the Fraction and then re-shadowed.
+             * @throw overflow_error if the result doesn't fit in a Fraction.
+            */
+            ShadowedFraction operator+(const ShadowedFraction& other) const;
+            ShadowedFraction operator-(const ShadowedFraction& other) const;
+            ShadowedFraction operator*(const ShadowedFraction& other) const;
+            ShadowedFraction operator/(const ShadowedFraction& other) const;
+
+            ShadowedFraction& operator+=(const ShadowedFraction& other) { return *this = *this + other; }
+            ShadowedFraction& operator-=(const ShadowedFraction& other) { return *this = *this - other; }
+            ShadowedFraction& operator*=(const ShadowedFraction& other) { return *this = *this * other; }
+            ShadowedFraction& operator/=(const ShadowedFraction& other) { return *this = *this / other; }
+
+            /*
+             * @brief Equality is exact (fractions are reduced, so it is a compare of two ints).
+            */
+            bool operator==(const ShadowedFraction& other) const noexcept { return _value == other._value; }
+            bool operator!=(const ShadowedFraction& other) const noexcept { return !(_value == other._value); }
+
+            bool operator<(const ShadowedFraction& other) const noexcept { return compare(other) < 0; }
+            bool operator>(const ShadowedFraction& other) const noexcept { return compare(other) > 0; }
+            bool operator<=(const ShadowedFraction& other) const noexcept { return compare(other) <= 0; }
+            bool operator>=(const ShadowedFraction& other) const noexcept { return compare(other) >= 0; }
+
+            /*
+             * @brief Prints the exact fraction (numerator/denominator).
+            */
+            friend std::ostream& operator<<(std::ostream& os, const ShadowedFraction& fraction);
+    };
+}
+
+#endif
@@ -0,0 +1,111 @@
+/*
+ *  Software Systems CPP Course Assignment 3
+ *  Copyright (C) 2023  Roy Simanovich
+ * 
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ * 
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <https://www.gnu.org/licenses/>.
+*/
+
+#include <limits>
+#include <stdexcept>
+#include "SmallFraction.hpp"
+
+using namespace std;
+
+namespace ariel
+{
+    SmallFraction::SmallFraction(const Fraction& fraction) {
+        if (fraction.numerator() < numeric_limits<int16_t>::min() || fraction.numerator() > numeric_limits<int16_t>::max() || fraction.denominator() > numeric_limits<uint16_t>::max())
+        {
+            FRACTION_COUNT(overflows);
+            FRACTION_COUNT(exceptions);
+            throw overflow_error("Fraction doesn't fit in a small fraction");
+        }
+
+        _numerator = static_cast<int16_t>(fraction.numerator());
+        _denominator = static_cast<uint16_t>(fraction.denominator());
+    }
+
+    SmallFraction::SmallFraction(int numerator, int denominator): SmallFraction(Fraction(numerator, denominator)) {}
+
+    SmallFraction::operator Fraction() const noexcept {
+        return Fraction::__unchecked(_numerator, _denominator);
+    }
+
+    /*
+     * @brief Unwraps the result of a checked operation.
+     * @param result The result of the operation.
+     * @return Fraction The value of the result.
+     * @throw invalid_argument if the operation divided by zero.
+     * @throw overflow_error if the reduced result doesn't fit in a Fraction.
+    */
+    static Fraction __value(const FractionResult& result) {
+        if (result.error == FractionError::DivisionByZero)
+        {
+            FRACTION_COUNT(exceptions);
+            throw invalid_argument("Can't divide by zero");
+        }
+
+        if (result.error == FractionError::Overflow)
+        {
+            FRACTION_COUNT(exceptions);
+            throw overflow_error("Result doesn't fit in a fraction");
+        }
+
+        return result.value;
+    }
+
+    Fraction operator+(const SmallFraction& a, const SmallFraction& b) {
+        return __value(checked_add(Fraction(a), Fraction(b)));
+    }
+
+    Fraction operator-(const SmallFraction& a, const SmallFraction& b) {
+        return __value(checked_sub(Fraction(a), Fraction(b)));
+    }
+
+    Fraction operator*(const SmallFraction& a, const SmallFraction& b) {
+        return __value(checked_mul(Fraction(a), Fraction(b)));
+    }
+
+    Fraction operator/(const SmallFraction& a, const SmallFraction& b) {
+        return __value(checked_div(Fraction(a), Fraction(b)));
+    }
+
+    bool operator==(const SmallFraction& a, const SmallFraction& b) noexcept {
+        return a._numerator == b._numerator && a._denominator == b._denominator;
+    }
+
+    bool operator!=(const SmallFraction& a, const SmallFraction& b) noexcept {
+        return !(a == b);
+    }
+
+    bool operator<(const SmallFraction& a, const SmallFraction& b) noexcept {
+        return a._numerator * b._denominator < b._numerator * a._denominator;
+    }
+
+    bool operator>(const SmallFraction& a, const SmallFraction& b) noexcept {
+        return b < a;
+    }
+
+    bool operator<=(const SmallFraction& a, const SmallFraction& b) noexcept {
+        return !(b < a);
+    }
+
+    bool operator>=(const SmallFraction& a, const SmallFraction& b) noexcept {
+        return !(a < b);
+    }
+
+    ostream& operator<<(ostream& os, const SmallFraction& fraction) {
+        os << fraction._numerator << "/" << fraction._denominator;
+        return os;
+    }
+}
@@ -0,0 +1,118 @@
+/*
+ *  Software Systems CPP Course Assignment 3
+ *  Copyright (C) 2023  Roy Simanovich
+ * 
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ * 
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <https://www.gnu.org/licenses/>.
+*/
+
+#ifndef _SMALLFRACTION_HPP
+#define _SMALLFRACTION_HPP
+
+#include <cstdint>
+#include <iostream>
+#include "Fraction.hpp"
+
+namespace ariel
+{
+    /*
+     * @brief A 4 byte storage type for fractions with a 16 bit numerator and denominator.
+     * @note Meant for huge arrays: it holds half as many bytes as a Fraction, and widens to one for free.
+     * @note Like Fraction, it is always reduced with a positive denominator.
+     * @note The arithmetic operators promote to Fraction, so a result is never truncated to 16 bits; one that doesn't fit a Fraction throws overflow_error.
+    */
+    class SmallFraction
+    {
+        private:
+            /*
+             * @brief The numerator of the fraction.
+            */
+            std::int16_t _numerator;
+
+            /*
+             * @brief The denominator of the fraction (never 0).
+            */
+            std::uint16_t _denominator;
+
+        public:
+            /*
+             * @brief Default constructor of the SmallFraction class.
+             * @note The default fraction is 0/1.
+            */
+            SmallFraction() noexcept: _numerator(0), _denominator(1) {}
+
+            /*
+             * @brief Narrows a fraction.
+             * @param fraction The fraction to narrow.
+             * @throw overflow_error if the numerator doesn't fit in an int16_t or the denominator in a uint16_t.
+            */
+            explicit SmallFraction(const Fraction& fraction);
+
+            /*
+             * @brief Constructs a fraction from a numerator and a denominator.
+             * @param numerator The numerator of the fraction.
+             * @param denominator The denominator of the fraction.
+             * @throw invalid_argument if the denominator is 0.
+             * @throw overflow_error if the reduced fraction doesn't fit.
+            */
+            SmallFraction(int numerator, int denominator);
+
+            /*
+             * @brief Returns the numerator of the fraction.
+             * @return int The numerator of the fraction.
+            */
+            int numerator() const { return _numerator; }
+
+            /*
+             * @brief Returns the denominator of the fraction.
+             * @return int The denominator of the fraction (always positive).
+            */
+            int denominator() const { return _denominator; }
+
+            /*
+             * @brief Widens the fraction to a Fraction (always exact).
+             * @return Fraction The widened fraction.
+            */
+            operator Fraction() const noexcept;
+
+            /*
+             * @brief Arithmetic operators, computed over 64 bit intermediates and reduced to a Fraction.
+             * @throw invalid_argument if dividing by zero.
+             * @throw overflow_error if the reduced result doesn't fit in a Fraction (e.g. 1/65535 + 1/65534).
+             * @note To store a result back, narrow it explicitly with SmallFraction(result).
+            */
+            friend Fraction operator+(const SmallFraction& a, const SmallFraction& b);
+            friend Fraction operator-(const SmallFraction& a, const SmallFraction& b);
+            friend Fraction operator*(const SmallFraction& a, const SmallFraction& b);
+            friend Fraction operator/(const SmallFraction& a, const SmallFraction& b);
+
+            /*
+             * @brief Comparison operators.
+             * @note The cross products of 16 bit members always fit in an int, so no widening is needed.
+            */
+            friend bool operator==(const SmallFraction& a, const SmallFraction& b) noexcept;
+            friend bool operator!=(const SmallFraction& a, const SmallFraction& b) noexcept;
+            friend bool operator<(const SmallFraction& a, const SmallFraction& b) noexcept;
+            friend bool operator>(const SmallFraction& a, const SmallFraction& b) noexcept;
+            friend bool operator<=(const SmallFraction& a, const SmallFraction& b) noexcept;
+            friend bool operator>=(const SmallFraction& a, const SmallFraction& b) noexcept;
+
+            /*
+             * @brief Prints the fraction like a Fraction (numerator/denominator).
+            */
+            friend std::ostream& operator<<(std::ostream& os, const SmallFraction& fraction);
+    };
+
+    static_assert(sizeof(SmallFraction) == 4, "SmallFraction must stay 4 bytes");
+}
+
+#endif
@@ -0,0 +1,225 @@
+/*
+ *  Software Systems CPP Course Assignment 3
+ *  Copyright (C) 2023  Roy Simanovich
+ * 
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ * 
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <https://www.gnu.org/licenses/>.
+*/
+
+#include <algorithm>
+#include <cerrno>
+#include <cstdlib>
+#include <exception>
+#include "ThreadPool.hpp"
+
+using namespace std;
+
+namespace ariel
+{
+    /*
+     * @brief The pool the calling thread is a worker of (nullptr for non-worker threads).
+    */
+    static thread_local ThreadPool* __current_pool = nullptr;
+
+    /*
+     * @brief The index of the calling worker thread in its pool.
+    */
+    static thread_local size_t __current_index = 0;
+
+    ThreadPool::ThreadPool(unsigned int workers): _pending(0), _next(0), _stop(false) {
+        if (workers == 0)
+            workers = max(1u, thread::hardware_concurrency());
+
+        for (unsigned int i = 0; i < workers; i++)
+            _queues.push_back(make_unique<Queue>());
+
+        for (size_t i = 0; i < workers; i++)
+            _threads.emplace_back(&ThreadPool::__worker_loop, this, i);
+    }
+
+    ThreadPool::~ThreadPool() {
+        {
+            lock_guard<mutex> guard(_sleep_lock);
+            _stop = true;
+        }
+
+        _wake.notify_all();
+
+        for (thread& worker : _threads)
+            worker.join();
+    }
+
+    size_t ThreadPool::__self() {
+        if (__current_pool == this)
+            return __current_index;
+
+        return _next.fetch_add(1, memory_order_relaxed) % _queues.size();
+    }
+
+    void ThreadPool::__push(function<void()> task) {
+        Queue& queue = *_queues[__self()];
+
+        // Counted before it is visible, so the counter never drops below the real number of queued tasks.
+        _pending.fetch_add(1);
+
+        {
+            lock_guard<mutex> guard(queue.lock);
+            queue.tasks.push_back(std::move(task));
+        }
+
+        // Taking the sleep lock orders the increment before a worker's predicate check, so no wakeup is lost.
+        {
+            lock_guard<mutex> guard(_sleep_lock);
+        }
+
+        _wake.notify_one();
+    }
+
+    bool ThreadPool::__take(size_t self, function<void()>& task) {
+        if (_pending.load() == 0)
+            return false;
+
+        size_t count = _queues.size();
+
+        for (size_t i = 0; i < count; i++)
+        {
+            Queue& queue = *_queues[(self + i) % count];
+            lock_guard<mutex> guard(queue.lock);
+
+            if (queue.tasks.empty())
+                continue;
+
+            if (i == 0)
+            {
+                task = std::move(queue.tasks.back());
+                queue.tasks.pop_back();
+            }
+
+            else
+            {
+                task = std::move(queue.tasks.front());
+                queue.tasks.pop_front();
+            }
+
+            _pending.fetch_sub(1);
+            return true;
+        }
+
+        return false;
+    }
+
+    void ThreadPool::__worker_loop(size_t index) {
+        __current_pool = this;
+        __current_index = index;
+
+        function<void()> task;
+
+        while (true)
+        {
+            if (__take(index, task))
+            {
+                task();
+                task = nullptr;
+                continue;
+            }
+
+            unique_lock<mutex> guard(_sleep_lock);
+            _wake.wait(guard, [this]() { return _stop.load() || _pending.load() > 0; });
+
+            if (_stop.load() && _pending.load() == 0)
+                return;
+        }
+    }
+
+    bool ThreadPool::run_pending() {
+        function<void()> task;
+
+        if (!__take(__self(), task))
+            return false;
+
+        task();
+        return true;
+    }
+
+    void ThreadPool::parallel_for(size_t count, const function<void(size_t)>& body) {
+        if (count == 0)
+            return;
+
+        atomic<size_t> remaining(count);
+        exception_ptr error = nullptr;
+        mutex error_lock;
+
+        auto run = [&](size_t index) {
+            try
+            {
+                body(index);
+            }
+
+            catch (...)
+            {
+                lock_guard<mutex> guard(error_lock);
+
+                if (error == nullptr)
+                    error = current_exception();
+            }
+
+            remaining.fetch_sub(1);
+        };
+
+        for (size_t i = 1; i < count; i++)
+            __push([&run, i]() { run(i); });
+
+        run(0);
+
+        // Help the pool instead of blocking, so nested calls from inside a task can't deadlock.
+        while (remaining.load() > 0)
+        {
+            if (!run_pending())
+                this_thread::yield();
+        }
+
+        if (error != nullptr)
+            rethrow_exception(error);
+    }
+
+    /*
+     * @brief The most workers the default pool starts per hardware thread.
+    */
+    static const unsigned int MAX_WORKERS_PER_THREAD = 4;
+
+    /*
+     * @brief Reads the number of workers of the default pool from the FRACTION_THREADS environment variable.
+     * @return unsigned int The number of workers, or 0 (one per hardware thread) if the variable isn't set or isn't a positive integer.
+     * @note Capped at MAX_WORKERS_PER_THREAD workers per hardware thread, so a typo can't start billions of threads.
+    */
+    static unsigned int __configured_workers() {
+        const char* value = getenv("FRACTION_THREADS");
+
+        if (value == nullptr)
+            return 0;
+
+        char* end = nullptr;
+        errno = 0;
+        long long workers = strtoll(value, &end, 10);
+
+        if (end == value || *end != '\0' || errno == ERANGE || workers <= 0)
+            return 0;
+
+        long long limit = static_cast<long long>(max(1u, thread::hardware_concurrency())) * MAX_WORKERS_PER_THREAD;
+        return static_cast<unsigned int>(min(workers, limit));
+    }
+
+    ThreadPool& ThreadPool::instance() {
+        static ThreadPool pool(__configured_workers());
+        return pool;
+    }
+}
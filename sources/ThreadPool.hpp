@@ -0,0 +1,171 @@
+/*
+ *  Software Systems CPP Course Assignment 3
+ *  Copyright (C) 2023  Roy Simanovich
+ * 
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ * 
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <https://www.gnu.org/licenses/>.
+*/
+
+#ifndef _THREADPOOL_HPP
+#define _THREADPOOL_HPP
+
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <functional>
+#include <future>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <type_traits>
+#include <vector>
+
+namespace ariel
+{
+    class ThreadPool
+    {
+        private:
+            /*
+             * @brief A task queue of a single worker.
+             * @note The owner pops from the back (LIFO, cache friendly), thieves steal from the front (FIFO).
+            */
+            struct Queue
+            {
+                std::mutex lock;
+                std::deque<std::function<void()>> tasks;
+            };
+
+            /*
+             * @brief The task queues, one per worker.
+            */
+            std::vector<std::unique_ptr<Queue>> _queues;
+
+            /*
+             * @brief The worker threads.
+            */
+            std::vector<std::thread> _threads;
+
+            /*
+             * @brief The lock and condition the idle workers sleep on.
+            */
+            std::mutex _sleep_lock;
+            std::condition_variable _wake;
+
+            /*
+             * @brief The number of tasks that are queued and not yet taken by a thread.
+            */
+            std::atomic<std::size_t> _pending;
+
+            /*
+             * @brief The queue the next task submitted from outside the pool goes to (round robin).
+            */
+            std::atomic<std::size_t> _next;
+
+            /*
+             * @brief True once the pool is shutting down.
+            */
+            std::atomic<bool> _stop;
+
+            /*
+             * @brief Queues a task.
+             * @param task The task to queue.
+             * @note A worker queues to its own deque, any other thread round robins over the deques.
+            */
+            void __push(std::function<void()> task);
+
+            /*
+             * @brief Takes a task from the given queue, or steals one from another queue.
+             * @param self The queue to take from first.
+             * @param task The taken task.
+             * @return True if a task was taken, false if all the queues are empty.
+            */
+            bool __take(std::size_t self, std::function<void()>& task);
+
+            /*
+             * @brief The main loop of a worker thread.
+             * @param index The index of the worker (and of its queue).
+            */
+            void __worker_loop(std::size_t index);
+
+            /*
+             * @brief Returns the index of the calling thread's queue.
+             * @return std::size_t The index of the queue if the calling thread is a worker of this pool, otherwise a round robin index.
+            */
+            std::size_t __self();
+
+        public:
+            /*
+             * @brief Constructs a thread pool.
+             * @param workers The number of worker threads (0 means one per hardware thread).
+            */
+            explicit ThreadPool(unsigned int workers = 0);
+
+            /*
+             * @brief Destroys the thread pool.
+             * @note Runs all the queued tasks, then joins the workers.
+            */
+            ~ThreadPool();
+
+            ThreadPool(const ThreadPool& other) = delete;
+            ThreadPool(ThreadPool&& other) = delete;
+            ThreadPool& operator=(const ThreadPool& other) = delete;
+            ThreadPool& operator=(ThreadPool&& other) = delete;
+
+            /*
+             * @brief Returns the number of worker threads.
+             * @return std::size_t The number of worker threads.
+            */
+            std::size_t workers() const { return _threads.size(); }
+
+            /*
+             * @brief Submits a task to the pool.
+             * @param function The task to run.
+             * @return std::future The future result of the task (exceptions are rethrown by get()).
+            */
+            template <typename Function>
+            std::future<std::invoke_result_t<Function>> submit(Function function) {
+                auto task = std::make_shared<std::packaged_task<std::invoke_result_t<Function>()>>(std::move(function));
+                auto result = task->get_future();
+
+                __push([task]() { (*task)(); });
+
+                return result;
+            }
+
+            /*
+             * @brief Runs a queued task on the calling thread, if there is one.
+             * @return True if a task was run, false if all the queues are empty.
+             * @note Used by threads that wait on the pool so they help instead of blocking.
+            */
+            bool run_pending();
+
+            /*
+             * @brief Runs body(0) ... body(count - 1) on the pool and waits for all of them.
+             * @param count The number of chunks.
+             * @param body The function to run on every chunk index.
+             * @throw Rethrows the first exception thrown by the body, after all the chunks are done.
+             * @note The calling thread runs chunks too, so it is safe to call from inside a task of the same pool.
+            */
+            void parallel_for(std::size_t count, const std::function<void(std::size_t)>& body);
+
+            /*
+             * @brief Returns the default thread pool, shared by all the batch APIs of the library.
+             * @return ThreadPool& The default thread pool.
+             * @note The number of workers is taken from the FRACTION_THREADS environment variable if set, otherwise one per hardware thread.
+             * @note A value that isn't a positive integer is ignored, and a huge one is capped at 4 workers per hardware thread.
+            */
+            static ThreadPool& instance();
+    };
+}
+
+#endif